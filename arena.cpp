@@ -0,0 +1,144 @@
+/* Rosa Knowles
+ * 11/19/2025
+ * Definitions for the methods of `GenerationArena`
+ */
+
+#include "arena.h"
+
+#include <algorithm>
+
+
+/* Constructor for the `GenerationArena` class
+ * Allocates the first block right away, so small maps never need a second one
+ */
+GenerationArena::GenerationArena(size_t initial_size, std::pmr::memory_resource * upstream_arg)
+{
+    upstream = upstream_arg;
+    add_block(std::max<size_t>(initial_size, 1));
+}
+
+// destructor
+GenerationArena::~GenerationArena()
+{
+    free_blocks();
+}
+
+/* Private function
+ * Allocates a block of at least `min_size` bytes from `upstream` and moves on to it
+ * Blocks double in size, so a big run only needs a handful of them
+ */
+void GenerationArena::add_block(size_t min_size)
+{
+    const size_t SIZE = std::max(min_size, blocks.empty() ? 0 : 2 * blocks.back().size);
+
+    // `max_align_t` is enough for anything that gets put in the arena, larger alignments are handled by padding
+    blocks.push_back({upstream->allocate(SIZE, alignof(std::max_align_t)), SIZE});
+    current = blocks.size() - 1;
+    offset = 0;
+}
+
+/* Private function
+ * Gives every block back to `upstream`
+ */
+void GenerationArena::free_blocks()
+{
+    for (const auto & block : blocks)
+    {
+        upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+    }
+    blocks.clear();
+    current = 0;
+    offset = 0;
+}
+
+/* Private function
+ * Hands out the next `bytes` bytes of the current block, aligned to `alignment`
+ * Moves on to the next block (or makes a new one) if it doesn't fit
+ */
+void * GenerationArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // tries to fit the allocation in the current block, returns `nullptr` if it doesn't fit
+    auto try_bump = [&]() -> void *
+    {
+        const Block & block = blocks[current];
+        const uintptr_t START = (uintptr_t)block.data + offset;
+        const size_t PADDING_BYTES = (alignment - START % alignment) % alignment;
+
+        if (offset + PADDING_BYTES + bytes > block.size)
+            return nullptr;
+
+        offset += PADDING_BYTES + bytes;
+        bytes_used += PADDING_BYTES + bytes;
+        return (void *)(START + PADDING_BYTES);
+    };
+
+    void * rtrnval = try_bump();
+
+    // blocks that are left over from a run that didn't fit in one block get reused before new ones are made
+    while (rtrnval == nullptr && current + 1 < blocks.size())
+    {
+        current++;
+        offset = 0;
+        rtrnval = try_bump();
+    }
+
+    if (rtrnval == nullptr)
+    {
+        // room for the worst case padding too
+        add_block(bytes + alignment);
+        rtrnval = try_bump();
+    }
+
+    return rtrnval;
+}
+
+void GenerationArena::do_deallocate(void * p, size_t bytes, size_t alignment)
+{
+    // memory is only ever freed all at once, by `reset`
+    (void)p;
+    (void)bytes;
+    (void)alignment;
+}
+
+bool GenerationArena::do_is_equal(const std::pmr::memory_resource & other) const noexcept
+{
+    return this == &other;
+}
+
+/* Frees everything that was allocated from the arena
+ * If the last run spilled over into more than one block, they are swapped for a single block that is as big as all of them,
+ * so the same run will fit in one block next time
+ */
+void GenerationArena::reset()
+{
+    if (blocks.size() > 1)
+    {
+        const size_t TOTAL = get_capacity();
+        free_blocks();
+        add_block(TOTAL);
+    }
+
+    current = 0;
+    offset = 0;
+    bytes_used = 0;
+}
+
+// Getters
+// (self explanatory)
+size_t GenerationArena::get_bytes_used() const
+{
+    return bytes_used;
+}
+size_t GenerationArena::get_capacity() const
+{
+    size_t rtrnval = 0;
+    for (const auto & block : blocks)
+    {
+        rtrnval += block.size;
+    }
+    return rtrnval;
+}
+size_t GenerationArena::get_num_blocks() const
+{
+    return blocks.size();
+}
@@ -0,0 +1,74 @@
+/* Rosa Knowles
+ * 11/19/2025
+ * Header file for `GenerationArena`, the memory resource that everything temporary in `DungeonMap::generate` comes from
+ * Allocations just bump a pointer, and nothing is freed until the whole arena is reset at the start of the next run
+ * After a reset, the arena keeps a single block as big as everything the last run used,
+ * so once it has seen the biggest map it is going to make, generating doesn't call `malloc` at all
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+
+
+class GenerationArena : public std::pmr::memory_resource
+{
+    private:
+        // a single chunk of memory from `upstream`
+        struct Block
+        {
+            void * data;
+            size_t size;
+        };
+
+        std::pmr::memory_resource * upstream;
+
+        // blocks are used in order, `current` is the one being handed out right now
+        std::vector<Block> blocks;
+        size_t current = 0;
+        // number of bytes of the current block that have been handed out
+        size_t offset = 0;
+
+        // bytes handed out since the last reset (including the padding for alignment)
+        size_t bytes_used = 0;
+
+        // allocates a new block that is at least `min_size` bytes, and makes it the current block
+        void add_block(size_t min_size);
+        // gives every block back to `upstream`
+        void free_blocks();
+
+        // memory_resource
+        void * do_allocate(size_t bytes, size_t alignment) override;
+        // does nothing, memory only gets freed by `reset`
+        void do_deallocate(void * p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override;
+
+    public:
+        // constructor
+        // `initial_size` is the size of the first block, which is allocated right away
+        explicit GenerationArena(size_t initial_size, std::pmr::memory_resource * upstream_arg = std::pmr::new_delete_resource());
+        // destructor
+        ~GenerationArena();
+
+        // owns its blocks, and containers keep pointers to it, so it can't be copied or moved
+        GenerationArena(const GenerationArena &) = delete;
+        GenerationArena & operator=(const GenerationArena &) = delete;
+
+        // frees everything that was allocated from the arena at once
+        // anything still using memory from the arena is left dangling, so it all has to be destroyed first
+        // if the last run needed more than one block, the blocks are merged into a single one for the next run
+        void reset();
+
+        // getters
+        // bytes handed out since the last reset
+        size_t get_bytes_used() const;
+        // total size of every block
+        size_t get_capacity() const;
+        size_t get_num_blocks() const;
+};
+
+#endif
@@ -0,0 +1,501 @@
+/* Rosa Knowles
+ * 11/18/2025
+ * Benchmarks for the dungeon generator, laid out like Google Benchmark (but without needing it installed)
+ * Every benchmark runs until it has taken at least `--min_time` seconds, and reports the average time per iteration
+ * The stages of `DungeonMap::generate` are private, so their timings come from `GenerationStats`
+ *
+ * `--large` adds a tier of 10000 room maps, which take seconds each and about a gigabyte of tiles
+ *
+ * Usage: bench.exe [--min_time=<seconds>] [--filter=<substring>] [--out=<json file>] [--large]
+ */
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <memory>
+#include <limits>
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include "dungeongen.h"
+#include "triangulation.h"
+#include "threadpool.h"
+
+using namespace std;
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // number of rooms in the generated maps
+    // the map grows with the square of the number of rooms, so much more than 1000 takes seconds per map
+    const vector<int> ROOM_COUNTS = {10, 25, 50, 100, 255, 1000};
+    // only run with `--large`, and skipped by the benchmarks that turn the whole map into text
+    const int LARGE_ROOM_COUNT = 10000;
+
+    // minimum and maximum side length of the rooms
+    const vector<pair<int, int>> ROOM_SIZES = {{3, 6}, {6, 10}, {10, 20}};
+
+    // the benchmarks cycle through seeds 1 to `NUM_SEEDS`, so every run generates the same maps
+    const int32_t NUM_SEEDS = 16;
+
+    // the room size used by the benchmarks that only sweep the number of rooms
+    const int DEFAULT_MIN_SIDE = 6;
+    const int DEFAULT_MAX_SIDE = 10;
+
+    struct BenchmarkResult
+    {
+        string name;
+        uint64_t iterations;
+        // average wall clock time per iteration
+        double real_time_ns;
+        // extra numbers, reported next to the time (rates, per stage timings, ...)
+        vector<pair<string, double>> counters;
+    };
+
+    struct Options
+    {
+        double min_time = 0.5;
+        string filter;
+        string out_path;
+        bool large = false;
+    };
+
+    /* Runs `iteration` over and over until it has taken at least `min_time` seconds
+     * `iteration` gets the index of the iteration, so it can pick a seed
+     * Returns the number of iterations and the total time
+     */
+    pair<uint64_t, double> run_for(double min_time, const function<void(uint64_t)> & iteration)
+    {
+        using namespace std::chrono;
+
+        const double MIN_NS = min_time * 1e9;
+        uint64_t iterations = 0;
+        const auto START = steady_clock::now();
+        double elapsed = 0;
+
+        // always do at least one iteration, even if it alone takes longer than `min_time`
+        do
+        {
+            iteration(iterations);
+            iterations++;
+            elapsed = duration_cast<nanoseconds>(steady_clock::now() - START).count();
+        }
+        while (elapsed < MIN_NS);
+
+        return {iterations, elapsed};
+    }
+
+    // keeps the compiler from throwing away a value that is never used
+    template <typename T>
+    void do_not_optimize(const T & value)
+    {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // name of a benchmark with its arguments, in the same style as Google Benchmark
+    string benchmark_name(const string & base, const vector<pair<string, int>> & args)
+    {
+        string rtrnval = base;
+        for (const auto & [key, value] : args)
+        {
+            rtrnval += "/" + key + ":" + to_string(value);
+        }
+        return rtrnval;
+    }
+
+    // whether a map of `num_rooms` rooms, with sides up to `max_side`, is small enough for a `ByteMatrix2D`
+    // uses the same spread as `DungeonMap::generate_rooms`
+    bool fits_in_matrix(int num_rooms, int max_side)
+    {
+        const uint64_t MAX_SHIFT = (uint64_t)max_side * num_rooms / ((num_rooms >= max_side) ? 3 : 2);
+        return MAX_SHIFT + max_side + 1 + 2 * PADDING <= numeric_limits<matrix_dim_t>::max();
+    }
+
+    // generates a map from the fixed seeds, used as the input of the non-generation benchmarks
+    DungeonMap make_map(int num_rooms)
+    {
+        DungeonMap rtrnval(DEFAULT_MIN_SIDE, DEFAULT_MAX_SIDE, num_rooms);
+        rtrnval.generate(1);
+        return rtrnval;
+    }
+
+
+    /* BM_Generate
+     * Times whole calls to `DungeonMap::generate`, and adds up the timings of each stage
+     * Stages are reported as average nanoseconds per map
+     */
+    BenchmarkResult bench_generate(const Options & options, int num_rooms, int min_side, int max_side)
+    {
+        // one map for every iteration, like a server that keeps generating maps would use
+        DungeonMap map(min_side, max_side, num_rooms);
+        GenerationStats totals;
+
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t i)
+        {
+            map.generate(1 + i % NUM_SEEDS);
+
+            const GenerationStats & stats = map.get_stats();
+            totals.rooms_ns += stats.rooms_ns;
+            totals.triangulation_ns += stats.triangulation_ns;
+            totals.graph_ns += stats.graph_ns;
+            totals.mst_ns += stats.mst_ns;
+            totals.hallways_ns += stats.hallways_ns;
+            totals.placement_fallbacks += stats.placement_fallbacks;
+            totals.peak_bytes = max(totals.peak_bytes, stats.peak_bytes);
+        });
+
+        const double N = iterations;
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name("BM_Generate", {{"rooms", num_rooms}, {"min_side", min_side}, {"max_side", max_side}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / N;
+        rtrnval.counters = {
+            {"maps_per_second", N * 1e9 / elapsed},
+            {"rooms_per_second", N * num_rooms * 1e9 / elapsed},
+            {"generate_rooms_ns", totals.rooms_ns / N},
+            {"Bowyer_Watson_ns", totals.triangulation_ns / N},
+            {"graph_build_ns", totals.graph_ns / N},
+            {"Prim_ns", totals.mst_ns / N},
+            {"generate_hallways_ns", totals.hallways_ns / N},
+            {"placement_fallbacks", totals.placement_fallbacks / N},
+            {"peak_bytes", (double)totals.peak_bytes}
+        };
+
+        return rtrnval;
+    }
+
+    /* BM_RouteHallways
+     * Times whole calls to `DungeonMap::generate` with `HallwayMode::ROUTED`, so it can be compared to BM_Generate
+     */
+    BenchmarkResult bench_route_hallways(const Options & options, int num_rooms)
+    {
+        DungeonMap map(DEFAULT_MIN_SIDE, DEFAULT_MAX_SIDE, num_rooms);
+        map.set_hallway_mode(HallwayMode::ROUTED);
+        GenerationStats totals;
+
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t i)
+        {
+            map.generate(1 + i % NUM_SEEDS);
+
+            const GenerationStats & stats = map.get_stats();
+            totals.hallways_ns += stats.hallways_ns;
+            totals.route_expansions += stats.route_expansions;
+            totals.tiles_written += stats.tiles_written;
+        });
+
+        const double N = iterations;
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name("BM_RouteHallways", {{"rooms", num_rooms}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / N;
+        rtrnval.counters = {
+            {"generate_hallways_ns", totals.hallways_ns / N},
+            {"route_expansions", totals.route_expansions / N},
+            {"tiles_written", totals.tiles_written / N}
+        };
+
+        return rtrnval;
+    }
+
+    /* BM_ParallelHallways
+     * Times whole calls to `DungeonMap::generate` with the hallways carved on a thread pool of `num_threads` threads
+     * `threads:1` doesn't use a pool at all, so it's the same as BM_Generate
+     * `carve_hallways_ns` is only the part that gets split up (carving and walls), without picking the connections
+     */
+    BenchmarkResult bench_parallel_hallways(const Options & options, int num_rooms, unsigned num_threads)
+    {
+        DungeonMap map(DEFAULT_MIN_SIDE, DEFAULT_MAX_SIDE, num_rooms);
+        unique_ptr<ThreadPool> pool;
+        if (num_threads > 1)
+        {
+            pool = make_unique<ThreadPool>(num_threads);
+            map.set_thread_pool(pool.get());
+        }
+        GenerationStats totals;
+
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t i)
+        {
+            map.generate(1 + i % NUM_SEEDS);
+            totals.hallways_ns += map.get_stats().hallways_ns;
+            totals.carve_ns += map.get_stats().carve_ns;
+        });
+
+        const double N = iterations;
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name("BM_ParallelHallways", {{"rooms", num_rooms}, {"threads", (int)num_threads}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / N;
+        // the thread count only means anything next to the number of cores it actually ran on
+        rtrnval.counters = {
+            {"generate_hallways_ns", totals.hallways_ns / N},
+            {"carve_hallways_ns", totals.carve_ns / N},
+            {"threads", (double)num_threads},
+            {"hardware_concurrency", (double)thread::hardware_concurrency()}
+        };
+
+        return rtrnval;
+    }
+
+    /* BM_Triangulate
+     * Times `dt::Triangulation` on its own, with the room centers of a generated map
+     * This is all `Bowyer_Watson` does besides copying out the centers
+     */
+    BenchmarkResult bench_triangulate(const Options & options, int num_rooms)
+    {
+        const DungeonMap MAP = make_map(num_rooms);
+        vector<CoordinatePair> centers;
+        for (const auto & rp : MAP.get_rooms())
+        {
+            centers.push_back(rp.center);
+        }
+
+        dt::Triangulation triangulation;
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t)
+        {
+            triangulation.triangulate(centers);
+            pmr::vector<Triangle> triangles = triangulation.get_triangles();
+            do_not_optimize(triangles.data());
+        });
+
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name("BM_Triangulate", {{"rooms", num_rooms}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / iterations;
+        rtrnval.counters = {{"rooms_per_second", (double)iterations * num_rooms * 1e9 / elapsed}};
+
+        return rtrnval;
+    }
+
+    /* BM_AsStr
+     * Times `ByteMatrix2D::as_str` (every tile as a 3 digit number) and `DungeonMap::as_str` (every tile as a character)
+     * on the matrix of a generated map
+     */
+    BenchmarkResult bench_as_str(const Options & options, int num_rooms, bool matrix_version)
+    {
+        const DungeonMap MAP = make_map(num_rooms);
+        const ByteMatrix2D * matrix = MAP.get_matrix();
+        const double TILES = (double)matrix->get_width() * matrix->get_height();
+
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t)
+        {
+            string text = matrix_version ? matrix->as_str(" ") : MAP.as_str();
+            do_not_optimize(text.data());
+        });
+
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name(matrix_version ? "BM_ByteMatrixAsStr" : "BM_DungeonMapAsStr", {{"rooms", num_rooms}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / iterations;
+        rtrnval.counters = {
+            {"tiles", TILES},
+            {"tiles_per_second", iterations * TILES * 1e9 / elapsed}
+        };
+
+        return rtrnval;
+    }
+
+    /* BM_GetConnections
+     * Times `SimpleGraph::get_connections` on the delaunay graph of a generated map
+     */
+    BenchmarkResult bench_get_connections(const Options & options, int num_rooms)
+    {
+        const DungeonMap MAP = make_map(num_rooms);
+        vector<CoordinatePair> centers;
+        for (const auto & rp : MAP.get_rooms())
+        {
+            centers.push_back(rp.center);
+        }
+
+        dt::Triangulation triangulation;
+        triangulation.triangulate(centers);
+
+        RoomGraph graph(centers);
+        for (const auto & tr : triangulation.get_triangles())
+        {
+            graph.mod_connection(tr.p1, tr.p2, sg::CONNECTED);
+            graph.mod_connection(tr.p1, tr.p3, sg::CONNECTED);
+            graph.mod_connection(tr.p2, tr.p3, sg::CONNECTED);
+        }
+
+        auto [iterations, elapsed] = run_for(options.min_time, [&](uint64_t)
+        {
+            auto connections = graph.get_connections();
+            do_not_optimize(connections.size());
+        });
+
+        BenchmarkResult rtrnval;
+        rtrnval.name = benchmark_name("BM_GetConnections", {{"rooms", num_rooms}});
+        rtrnval.iterations = iterations;
+        rtrnval.real_time_ns = elapsed / iterations;
+        rtrnval.counters = {
+            {"edges", (double)graph.count_connections()},
+            {"vertices_per_second", (double)iterations * num_rooms * 1e9 / elapsed}
+        };
+
+        return rtrnval;
+    }
+
+
+    // prints a single result as a row of the console table
+    void print_result(const BenchmarkResult & result)
+    {
+        ostringstream row;
+        row << result.name;
+        while (row.tellp() < 50)
+            row << ' ';
+        row << result.real_time_ns << " ns  " << result.iterations << " iterations";
+        for (const auto & [key, value] : result.counters)
+        {
+            row << "  " << key << "=" << value;
+        }
+        cout << row.str() << endl;
+    }
+
+    // writes every result to `path` as json, in the same layout as Google Benchmark's `--benchmark_out`
+    void write_json(const vector<BenchmarkResult> & results, const Options & options)
+    {
+        ofstream file(options.out_path, ios::out | ios::trunc);
+        if (!file)
+        {
+            cerr << "File `" << options.out_path << "` failed to open." << endl;
+            exit(1);
+        }
+
+        char date[64];
+        const time_t NOW = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&NOW));
+
+        file << "{\n";
+        file << "  \"context\": {\n";
+        file << "    \"date\": \"" << date << "\",\n";
+        file << "    \"num_cpus\": " << thread::hardware_concurrency() << ",\n";
+        file << "    \"min_time\": " << options.min_time << ",\n";
+        file << "    \"large\": " << (options.large ? "true" : "false") << ",\n";
+        file << "    \"num_seeds\": " << NUM_SEEDS << "\n";
+        file << "  },\n";
+        file << "  \"benchmarks\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const BenchmarkResult & result = results[i];
+
+            file << "    {\n";
+            file << "      \"name\": \"" << result.name << "\",\n";
+            file << "      \"iterations\": " << result.iterations << ",\n";
+            file << "      \"real_time\": " << result.real_time_ns << ",\n";
+            for (const auto & [key, value] : result.counters)
+            {
+                file << "      \"" << key << "\": " << value << ",\n";
+            }
+            file << "      \"time_unit\": \"ns\"\n";
+            file << "    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        file << "  ]\n";
+        file << "}\n";
+    }
+};
+
+
+int main(int argc, char ** argv)
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const string ARG = argv[i];
+
+        if (ARG.rfind("--min_time=", 0) == 0)
+            options.min_time = stod(ARG.substr(11));
+        else if (ARG.rfind("--filter=", 0) == 0)
+            options.filter = ARG.substr(9);
+        else if (ARG.rfind("--out=", 0) == 0)
+            options.out_path = ARG.substr(6);
+        else if (ARG == "--large")
+            options.large = true;
+        else
+        {
+            cerr << "Unknown argument `" << ARG << "`" << endl;
+            cerr << "Usage: " << argv[0] << " [--min_time=<seconds>] [--filter=<substring>] [--out=<json file>] [--large]" << endl;
+            return 1;
+        }
+    }
+
+    // every benchmark, paired with its name so it can be filtered before it runs
+    vector<pair<string, function<BenchmarkResult()>>> benchmarks;
+
+    vector<int> generate_room_counts = ROOM_COUNTS;
+    if (options.large)
+        generate_room_counts.push_back(LARGE_ROOM_COUNT);
+    for (int num_rooms : generate_room_counts)
+    {
+        for (const auto & [min_side, max_side] : ROOM_SIZES)
+        {
+            // the biggest rooms spread out too far for a `ByteMatrix2D` at 10000 rooms (unless it's wide)
+            if (!fits_in_matrix(num_rooms, max_side))
+                continue;
+
+            benchmarks.push_back({benchmark_name("BM_Generate", {{"rooms", num_rooms}, {"min_side", min_side}, {"max_side", max_side}}),
+                                  [&, num_rooms, min_side, max_side]() { return bench_generate(options, num_rooms, min_side, max_side); }});
+        }
+    }
+    // only the big maps have enough rows to split up
+    vector<unsigned> thread_counts = {1, 2, 4};
+    if (thread::hardware_concurrency() > 4)
+        thread_counts.push_back(thread::hardware_concurrency());
+    vector<int> parallel_room_counts = {1000};
+    if (options.large)
+        parallel_room_counts.push_back(LARGE_ROOM_COUNT);
+    for (int num_rooms : parallel_room_counts)
+    {
+        for (unsigned num_threads : thread_counts)
+        {
+            benchmarks.push_back({benchmark_name("BM_ParallelHallways", {{"rooms", num_rooms}, {"threads", (int)num_threads}}),
+                                  [&, num_rooms, num_threads]() { return bench_parallel_hallways(options, num_rooms, num_threads); }});
+        }
+    }
+    for (int num_rooms : ROOM_COUNTS)
+    {
+        benchmarks.push_back({benchmark_name("BM_RouteHallways", {{"rooms", num_rooms}}),
+                              [&, num_rooms]() { return bench_route_hallways(options, num_rooms); }});
+        benchmarks.push_back({benchmark_name("BM_Triangulate", {{"rooms", num_rooms}}),
+                              [&, num_rooms]() { return bench_triangulate(options, num_rooms); }});
+        benchmarks.push_back({benchmark_name("BM_ByteMatrixAsStr", {{"rooms", num_rooms}}),
+                              [&, num_rooms]() { return bench_as_str(options, num_rooms, true); }});
+        benchmarks.push_back({benchmark_name("BM_DungeonMapAsStr", {{"rooms", num_rooms}}),
+                              [&, num_rooms]() { return bench_as_str(options, num_rooms, false); }});
+        benchmarks.push_back({benchmark_name("BM_GetConnections", {{"rooms", num_rooms}}),
+                              [&, num_rooms]() { return bench_get_connections(options, num_rooms); }});
+    }
+
+    if (options.large)
+    {
+        benchmarks.push_back({benchmark_name("BM_Triangulate", {{"rooms", LARGE_ROOM_COUNT}}),
+                              [&]() { return bench_triangulate(options, LARGE_ROOM_COUNT); }});
+        benchmarks.push_back({benchmark_name("BM_GetConnections", {{"rooms", LARGE_ROOM_COUNT}}),
+                              [&]() { return bench_get_connections(options, LARGE_ROOM_COUNT); }});
+    }
+
+    cout << "Running on " << thread::hardware_concurrency() << " hardware threads" << endl;
+
+    vector<BenchmarkResult> results;
+    for (const auto & [name, benchmark] : benchmarks)
+    {
+        if (name.find(options.filter) == string::npos)
+            continue;
+
+        results.push_back(benchmark());
+        print_result(results.back());
+    }
+
+    if (!options.out_path.empty())
+        write_json(results, options);
+
+    return 0;
+}
@@ -5,46 +5,65 @@
 
 #include "bytematrix2d.h"
 
+#include <cstring>
+#include <array>
+
 /* Constructor for the `ByteMatrix2D` class
  * dynamically allocates a 2D array based off of the parameters given
  */
-ByteMatrix2D::ByteMatrix2D(uint16_t w, uint16_t h)
+ByteMatrix2D::ByteMatrix2D(matrix_dim_t w, matrix_dim_t h)
 {
     // store width and height, used for bounds checking
     width = w;
     height = h;
 
     // allocate the memory for the matrix
-    // allocates "width * height" bytes
-    // `{0}` ensures each of the bytes are initialized to 0
-    matrix = new uint8_t[w * h]{0};
+    // allocates "width * height" bytes, each initialized to 0
+    matrix.assign((size_t)w * h, 0);
 }
 
 /* Default constructor for the `ByteMatrix2D` class
  * Exists just so the compiler won't yell at me 
- * Initializes everything to 0 or nullptr
+ * Makes an empty (0 x 0) matrix
  */
 ByteMatrix2D::ByteMatrix2D()
 {
-    width = 0;
-    height = 0;
-    matrix = nullptr;
 }
 
-/* Destructor for the `ByteMatrix2D` class
- * ensures `matrix` is freed
+/* Move constructor for the `ByteMatrix2D` class
+ * Takes `other`'s buffer, leaving `other` as an empty matrix
  */
-ByteMatrix2D::~ByteMatrix2D()
+ByteMatrix2D::ByteMatrix2D(ByteMatrix2D && other) noexcept
+    : width(other.width), height(other.height), matrix(std::move(other.matrix))
 {
-    // square brackets used here since `matrix` is an array
-    if (matrix != nullptr)
-        delete[] matrix;
+    other.width = 0;
+    other.height = 0;
+    other.matrix.clear();
+}
+
+/* Move assignment for the `ByteMatrix2D` class
+ * Same as the move constructor
+ */
+ByteMatrix2D & ByteMatrix2D::operator=(ByteMatrix2D && other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    width = other.width;
+    height = other.height;
+    matrix = std::move(other.matrix);
+
+    other.width = 0;
+    other.height = 0;
+    other.matrix.clear();
+
+    return *this;
 }
 
 /* Returns the value at a specified coordinate in `matrix`
  * Throws an `std::out_of_range` exception if the bounds are out of range
  */
-uint8_t ByteMatrix2D::get(uint16_t x, uint16_t y)
+uint8_t ByteMatrix2D::get(matrix_dim_t x, matrix_dim_t y) const
 {
     using namespace std; 
 
@@ -59,14 +78,15 @@ uint8_t ByteMatrix2D::get(uint16_t x, uint16_t y)
             + to_string(width) + " x " + to_string(height));
     }
 
-    // moves the pointer to the `x`th row, and the `y`th column (i think)
-    return *(matrix + (width * y) + x);
+    // moves the pointer to the `y`th row, and the `x`th column
+    // cast to `size_t` first, since `width * y` can overflow an int for big matrices
+    return matrix[((size_t)width * y) + x];
 }
 
 /* Sets value at a specified coordinate in `matrix`
  * Throws an `std::out_of_range` exception if the bounds are out of range
  */
-void ByteMatrix2D::set(uint16_t x, uint16_t y, uint8_t val)
+void ByteMatrix2D::set(matrix_dim_t x, matrix_dim_t y, uint8_t val)
 {
     using namespace std;
 
@@ -79,56 +99,173 @@ void ByteMatrix2D::set(uint16_t x, uint16_t y, uint8_t val)
     }
 
     // same pointer math as in `ByteMatrix2D::get`
-    *(matrix + (width * y) + x) = val;
+    matrix[((size_t)width * y) + x] = val;
+}
+
+/* Changes the size of the matrix to `w` x `h`
+ * A vector never gives back its capacity when it shrinks, so a matrix that gets resized over and over
+ * only reallocates when it grows past the biggest size it has been
+ * The values aren't cleared, so they should be overwritten after resizing
+ */
+void ByteMatrix2D::resize(matrix_dim_t w, matrix_dim_t h)
+{
+    matrix.resize((size_t)w * h);
+
+    width = w;
+    height = h;
 }
 
 /* Converts `matrix` to a string
  * has a parameter `seperator`, which will be placed inbetween each element in the matrix
  * `seperator` has a default value of ""
  * Each element in the matrix will be printed as its integer representation, instead of its ASCII representation
+ * The digits for every possible byte are looked up from a table, and the string is sized once up front
  */
-std::string ByteMatrix2D::as_str(std::string seperator)
+std::string ByteMatrix2D::as_str(std::string seperator) const
 {
     using namespace std;
 
-    string rtrnval = "";
-
-    for (uint32_t i = 0; i < width * height; ++i)
+    // table of the 3 digit (zero padded) representation of every byte, "000" to "255"
+    // built the first time this function gets called
+    static const auto DIGITS = []
     {
-        const uint8_t VAL = matrix[i]; 
-        // add leading zeroes
-        // all bytes are max 3 digits, so we only need to account for the cases where
-        // VAL < 10 and VAL < 100
-        if (VAL < 10)
-        {
-            rtrnval.append("00");
-        }
-        else if (VAL < 100)
+        array<array<char, 3>, 256> table;
+        for (int i = 0; i < 256; ++i)
         {
-            rtrnval.append("0");
+            table[i] = { char('0' + i / 100), char('0' + (i / 10) % 10), char('0' + i % 10) };
         }
+        return table;
+    }();
 
-        rtrnval.append(to_string(VAL));
-        rtrnval.append(seperator);
+    if (width == 0 || height == 0)
+        return "";
 
-        // adds a newline at the end of a row
-        if ((i + 1) % width == 0)
+    const size_t SEP_LEN = seperator.size();
+    const size_t ELEMENT_LEN = 3 + SEP_LEN;
+
+    // every element and its seperator, plus a newline at the end of every row but the last one
+    string rtrnval;
+    rtrnval.resize((size_t)width * height * ELEMENT_LEN + height - 1);
+
+    char * out = &rtrnval[0];
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        const uint8_t * ROW = row(y);
+
+        for (matrix_dim_t x = 0; x < width; ++x)
         {
-            rtrnval.append("\n");
+            memcpy(out, DIGITS[ROW[x]].data(), 3);
+            memcpy(out + 3, seperator.data(), SEP_LEN);
+            out += ELEMENT_LEN;
         }
+
+        // adds a newline at the end of a row
+        if (y + 1 < height)
+            *out++ = '\n';
+    }
+
+    return rtrnval;
+}
+
+/* Sets every value in the matrix to `val`
+ * The matrix is one contiguous block, so this is a single `memset`
+ */
+void ByteMatrix2D::fill(uint8_t val)
+{
+    if (!matrix.empty())
+        memset(matrix.data(), val, matrix.size());
+}
+
+/* Sets every value in the `w` x `h` rectangle with its top-left corner at (`x`, `y`) to `val`
+ * Each row of the rectangle is contiguous, so this is one `memset` per row
+ * Throws an `std::out_of_range` exception if the rectangle doesn't fit in the matrix
+ */
+void ByteMatrix2D::fill_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val)
+{
+    // bounds checking is done once for the whole rectangle, instead of once per value
+    check_rect(x, y, w, h);
+
+    for (uint64_t i = y; i < (uint64_t)y + h; ++i)
+    {
+        memset(matrix.data() + ((size_t)width * i) + x, val, w);
     }
+}
+
+/* Sets the values on the edges of the `w` x `h` rectangle with its top-left corner at (`x`, `y`) to `val`
+ * The top and bottom rows are one `memset` each, and every row in between only has its first and last values set
+ * Throws an `std::out_of_range` exception if the rectangle doesn't fit in the matrix
+ */
+void ByteMatrix2D::frame_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val)
+{
+    check_rect(x, y, w, h);
+
+    if (w == 0 || h == 0)
+        return;
+
+    uint8_t * top = matrix.data() + ((size_t)width * y) + x;
+    memset(top, val, w);
+
+    for (uint64_t i = 1; i + 1 < h; ++i)
+    {
+        uint8_t * ROW = top + (size_t)width * i;
+        ROW[0] = val;
+        ROW[w - 1] = val;
+    }
+
+    if (h > 1)
+        memset(top + (size_t)width * (h - 1), val, w);
+}
+
+/* Sets every value inside the `w` x `h` rectangle with its top-left corner at (`x`, `y`) to `val`
+ * The inside is the rectangle without its edges, so this is `fill_rect` on a rectangle 2 smaller on each side
+ * Rectangles 2 or less wide or tall don't have an inside, so nothing gets set
+ * Throws an `std::out_of_range` exception if the rectangle doesn't fit in the matrix
+ */
+void ByteMatrix2D::fill_rect_interior(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val)
+{
+    check_rect(x, y, w, h);
 
-    // removes the last newline in the string, and returns it
-    return rtrnval.erase(rtrnval.size() - 1);
+    if (w <= 2 || h <= 2)
+        return;
+
+    fill_rect(x + 1, y + 1, w - 2, h - 2, val);
+}
+
+/* Protected function
+ * Throws an `std::out_of_range` exception if the `w` x `h` rectangle with its top-left corner at (`x`, `y`)
+ * doesn't fit in the matrix
+ */
+void ByteMatrix2D::check_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h) const
+{
+    using namespace std;
+
+    if ((uint64_t)x + w > width || (uint64_t)y + h > height)
+    {
+        throw out_of_range("Rectangle at (" + to_string(x) + ", " + to_string(y) + ") of size "
+            + to_string(w) + " x " + to_string(h) + " out of range for ByteMatrix2D of size "
+            + to_string(width) + " x " + to_string(height));
+    }
 }
 
 // Getters
 // (self explanatory)
-uint16_t ByteMatrix2D::get_width()
+matrix_dim_t ByteMatrix2D::get_width() const
 {
     return width;
 }
-uint16_t ByteMatrix2D::get_height()
+matrix_dim_t ByteMatrix2D::get_height() const
 {
     return height;
-}
\ No newline at end of file
+}
+size_t ByteMatrix2D::get_capacity() const
+{
+    return matrix.capacity();
+}
+uint8_t * ByteMatrix2D::get_data()
+{
+    return matrix.data();
+}
+const uint8_t * ByteMatrix2D::get_data() const
+{
+    return matrix.data();
+}
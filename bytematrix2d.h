@@ -7,40 +7,113 @@
 #define BYTEMATRIX2D_H
 
 #include <cstdint>
+#include <cstddef>
 #include <string>
+#include <vector>
 #include <stdexcept>
+// used for the bounds checks in the fast path accessors (only when `NDEBUG` isn't defined)
+#include <cassert>
+
+/* Type of the width and height of a `ByteMatrix2D`
+ * 16 bits is plenty for a normal map, and keeps every coordinate small
+ * Define `DUNGEONGEN_WIDE_MATRIX` (for the library and everything that uses it) for maps over 65535 tiles on a side
+ */
+#ifdef DUNGEONGEN_WIDE_MATRIX
+typedef uint32_t matrix_dim_t;
+#else
+typedef uint16_t matrix_dim_t;
+#endif
 
 /* Class that stores a matrix of unsigned 8-bit integers
 * Can be an arbitrary size
+* The bytes are stored in a `std::vector`, so matrices can be copied, moved, and returned by value
 */
 class ByteMatrix2D
 {
     protected:
         // stores the width and height of the matrix
-        uint16_t width;
-        uint16_t height;
+        matrix_dim_t width = 0;
+        matrix_dim_t height = 0;
 
-        // dynamically allocated matrix
-        uint8_t * matrix = nullptr;
+        // the values of the matrix, row by row (always `width * height` of them)
+        // its capacity can be bigger than that after shrinking, see `resize`
+        std::vector<uint8_t> matrix;
+
+        // throws an `std::out_of_range` exception if the rectangle doesn't fit, used by the bulk writes
+        void check_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h) const;
 
     public:
         // constructor
-        ByteMatrix2D(uint16_t w, uint16_t h);
+        ByteMatrix2D(matrix_dim_t w, matrix_dim_t h);
         // default constructor :sob:
         ByteMatrix2D();
-        // destructor
-        ~ByteMatrix2D();
+
+        // copying copies every value
+        // moving steals the buffer, and leaves the moved-from matrix empty (0 x 0)
+        ByteMatrix2D(const ByteMatrix2D & other) = default;
+        ByteMatrix2D & operator=(const ByteMatrix2D & other) = default;
+        ByteMatrix2D(ByteMatrix2D && other) noexcept;
+        ByteMatrix2D & operator=(ByteMatrix2D && other) noexcept;
 
         // get value at specified coordinates
-        uint8_t get(uint16_t x, uint16_t y);
+        uint8_t get(matrix_dim_t x, matrix_dim_t y) const;
         // set value at specified coordinates
-        void set(uint16_t x, uint16_t y, uint8_t val);
+        void set(matrix_dim_t x, matrix_dim_t y, uint8_t val);
         // converts matrix to a string, useful for printing 
-        std::string as_str(std::string seperator = "");
+        std::string as_str(std::string seperator = "") const;
+
+        // FAST PATH ACCESSORS
+        // these skip the bounds checking in `get` and `set` (and the exceptions that come with it)
+        // out of range coordinates only get caught by an `assert` in debug builds,
+        // so these should only be used when the caller already knows the coordinates are valid
+        uint8_t get_unchecked(matrix_dim_t x, matrix_dim_t y) const
+        {
+            assert(x < width && y < height);
+            return matrix[(size_t)width * y + x];
+        }
+        uint8_t & operator()(matrix_dim_t x, matrix_dim_t y)
+        {
+            assert(x < width && y < height);
+            return matrix[(size_t)width * y + x];
+        }
+        uint8_t operator()(matrix_dim_t x, matrix_dim_t y) const
+        {
+            return get_unchecked(x, y);
+        }
+        // pointer to the first of the `width` bytes in row `y`
+        uint8_t * row(matrix_dim_t y)
+        {
+            assert(y < height);
+            return matrix.data() + (size_t)width * y;
+        }
+        const uint8_t * row(matrix_dim_t y) const
+        {
+            assert(y < height);
+            return matrix.data() + (size_t)width * y;
+        }
+
+        // changes the size of the matrix, only reallocating if it needs more bytes than it already has
+        // the values are left as whatever was in memory, so they should be overwritten (e.g. with `fill`)
+        void resize(matrix_dim_t w, matrix_dim_t h);
+
+        // BULK WRITES
+        // set every value in the matrix to `val`
+        void fill(uint8_t val);
+        // set every value in the `w` x `h` rectangle with its top-left corner at (`x`, `y`) to `val`
+        void fill_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val);
+        // set the values on the edges of that rectangle (1 value thick) to `val`, leaving the inside alone
+        void frame_rect(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val);
+        // set the values inside that rectangle (everything but the edges) to `val`, leaving the edges alone
+        void fill_rect_interior(matrix_dim_t x, matrix_dim_t y, matrix_dim_t w, matrix_dim_t h, uint8_t val);
 
         // getters
-        uint16_t get_width();
-        uint16_t get_height();
+        matrix_dim_t get_width() const;
+        matrix_dim_t get_height() const;
+        size_t get_capacity() const;
+        // raw bytes of the matrix, stored row by row (`width` bytes per row)
+        // no bounds checking, so only use this for code that walks the whole matrix
+        uint8_t * get_data();
+        const uint8_t * get_data() const;
 };
 
 #endif
\ No newline at end of file
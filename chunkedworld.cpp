@@ -0,0 +1,363 @@
+/* Rosa Knowles
+ * 11/20/2025
+ * Definitions for the methods of `ChunkedWorld` and `WorldChunk`
+ */
+
+#include "chunkedworld.h"
+#include "tilekernels.h"
+
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    /* splitmix64 finalizer
+     * scrambles the bits of `x`, so nearby chunk positions end up with unrelated seeds
+     * https://prng.di.unimi.it/splitmix64.c
+     */
+    uint64_t mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    // rounds towards negative infinity, so tiles left of (or above) the origin end up in chunk -1 instead of chunk 0
+    int64_t floor_div(int64_t a, int64_t b)
+    {
+        return (a >= 0) ? a / b : -((-a + b - 1) / b);
+    }
+
+    /* Carves a hallway 2 tiles wide from `from` to `to`
+     * Goes along the x-axis first if `x_first` is true, otherwise along the y-axis first
+     * The hallway covers `from` to `to` and the tile after each of them, so both coordinates have to be
+     * at most `width - 2` (or `height - 2`)
+     */
+    void carve_hallway(ByteMatrix2D & matrix, CoordinatePair from, CoordinatePair to, bool x_first)
+    {
+        using namespace std;
+
+        // corner of the L
+        const CoordinatePair CORNER = x_first ? CoordinatePair{to.X, from.Y} : CoordinatePair{from.X, to.Y};
+
+        // fills in the box between `a` and `b`, plus one extra tile in each direction
+        auto carve_segment = [&](CoordinatePair a, CoordinatePair b)
+        {
+            const int32_t X_START = min(a.X, b.X);
+            const int32_t X_END = max(a.X, b.X) + 1;
+            const int32_t Y_START = min(a.Y, b.Y);
+            const int32_t Y_END = max(a.Y, b.Y) + 1;
+
+            for (int32_t y = Y_START; y <= Y_END; ++y)
+            {
+                memset(matrix.row(y) + X_START, TILES::FLOOR, X_END - X_START + 1);
+            }
+        };
+
+        carve_segment(from, CORNER);
+        carve_segment(CORNER, to);
+    }
+};
+
+
+/* Returns the number of bytes held by a chunk
+ */
+size_t WorldChunk::get_memory_usage() const
+{
+    return sizeof(WorldChunk)
+         + tiles.get_capacity()
+         + rooms.capacity() * sizeof(RoomPairs)
+         + hall_edges.capacity() * sizeof(HallEdge);
+}
+
+
+/* Constructor for the `ChunkedWorld` class
+ * Nothing gets generated until a chunk is asked for
+ */
+ChunkedWorld::ChunkedWorld(int32_t world_seed_arg, uint16_t chunk_size_arg,
+                           uint16_t min_room_len, uint16_t max_room_len, uint32_t rooms_per_chunk,
+                           size_t memory_budget_arg)
+    : generator(min_room_len, max_room_len, rooms_per_chunk)
+{
+    // each door has to stay `PADDING` tiles away from the corners of the chunk, and is 2 tiles wide
+    if (chunk_size_arg < 2 * PADDING + 2)
+    {
+        throw std::invalid_argument("Chunks must be at least " + std::to_string(2 * PADDING + 2)
+            + " tiles wide, got " + std::to_string(chunk_size_arg));
+    }
+
+    // the hallways from the doors need a room to go to
+    if (rooms_per_chunk == 0)
+        throw std::invalid_argument("Chunks must have at least one room");
+
+    world_seed = world_seed_arg;
+    chunk_size = chunk_size_arg;
+    memory_budget = memory_budget_arg;
+}
+
+/* Private function
+ * Packs the position of a chunk into a single key for `chunks`
+ */
+uint64_t ChunkedWorld::chunk_key(int32_t cx, int32_t cy)
+{
+    return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+}
+
+/* Private function
+ * Returns the seed of the chunk at (`cx`, `cy`)
+ * If the rooms from one seed don't fit in the chunk, the next `attempt` gives a different seed
+ */
+int32_t ChunkedWorld::chunk_seed(int32_t cx, int32_t cy, uint32_t attempt) const
+{
+    return (int32_t)mix(mix((uint64_t)(uint32_t)world_seed) ^ mix(chunk_key(cx, cy)) ^ attempt);
+}
+
+/* Private function
+ * Returns where the door is on the border to the right of (`horizontal` == true) or below the chunk at (`cx`, `cy`)
+ * The chunks on both sides of the border get the same answer, which is what connects them
+ */
+uint16_t ChunkedWorld::door_offset(int32_t cx, int32_t cy, bool horizontal) const
+{
+    // the door can go anywhere that is `PADDING` tiles away from the corners, so the walls of the doors don't touch
+    const uint16_t FIRST = PADDING;
+    const uint16_t NUM_POSITIONS = chunk_size - 2 * PADDING - 1;
+
+    const uint64_t HASH = mix(mix((uint64_t)(uint32_t)world_seed + 1) ^ mix(chunk_key(cx, cy)) ^ (horizontal ? 1 : 2));
+
+    return FIRST + HASH % NUM_POSITIONS;
+}
+
+/* Private function
+ * Generates the chunk at (`cx`, `cy`)
+ *      - generates a map for the chunk, and centers it in the chunk
+ *      - carves a hallway from each of the chunk's 4 doors to the nearest room
+ *      - chains the rooms together if the map didn't have any hallways between them
+ *      - puts walls around the new hallways
+ */
+std::shared_ptr<WorldChunk> ChunkedWorld::generate_chunk(int32_t cx, int32_t cy)
+{
+    using namespace std;
+
+    // rooms get pushed outwards when they run out of placement attempts, so every so often a map is too big for the chunk
+    // when that happens, another seed is tried
+    const ByteMatrix2D * map_matrix = nullptr;
+    int32_t seed = 0;
+    for (uint32_t attempt = 0; attempt < CHUNK_GENERATION_ATTEMPTS && map_matrix == nullptr; ++attempt)
+    {
+        seed = chunk_seed(cx, cy, attempt);
+        generator.generate(seed);
+
+        const ByteMatrix2D * matrix = generator.get_matrix();
+        if (matrix != nullptr && matrix->get_width() <= chunk_size && matrix->get_height() <= chunk_size)
+            map_matrix = matrix;
+    }
+
+    if (map_matrix == nullptr)
+    {
+        throw runtime_error("Couldn't fit the rooms of chunk (" + to_string(cx) + ", " + to_string(cy)
+            + ") in " + to_string(chunk_size) + " x " + to_string(chunk_size) + " tiles, use bigger chunks or fewer rooms");
+    }
+
+    shared_ptr<WorldChunk> rtrnval = make_shared<WorldChunk>();
+    rtrnval->cx = cx;
+    rtrnval->cy = cy;
+    rtrnval->seed = seed;
+    rtrnval->tiles = ByteMatrix2D(chunk_size, chunk_size);
+    rtrnval->tiles.fill(TILES::EMPTY);
+
+    ByteMatrix2D & tiles = rtrnval->tiles;
+
+    // center the map in the chunk
+    const CoordinatePair OFFSET =
+    {
+        ((int32_t)chunk_size - (int32_t)map_matrix->get_width()) / 2,
+        ((int32_t)chunk_size - (int32_t)map_matrix->get_height()) / 2
+    };
+    for (uint32_t y = 0; y < map_matrix->get_height(); ++y)
+    {
+        memcpy(tiles.row(OFFSET.Y + y) + OFFSET.X, map_matrix->row(y), map_matrix->get_width());
+    }
+
+    // hallways start from the centers of the rooms (in chunk coordinates)
+    vector<CoordinatePair> centers;
+    centers.reserve(generator.get_rooms().size());
+    for (const auto & rp : generator.get_rooms())
+    {
+        centers.push_back(shift(rp, OFFSET).center);
+    }
+
+    // doors on the left, top, right and bottom borders
+    // the left and top doors belong to the borders of the chunks to the left and above
+    const uint16_t LAST = chunk_size - 1;
+    const CoordinatePair DOORS[4] =
+    {
+        {0, door_offset(cx - 1, cy, true)},
+        {door_offset(cx, cy - 1, false), 0},
+        {LAST - 1, door_offset(cx, cy, true)},
+        {door_offset(cx, cy, false), LAST - 1}
+    };
+
+    for (uint8_t i = 0; i < 4; ++i)
+    {
+        // find the nearest room
+        const CoordinatePair * nearest = &centers.front();
+        for (const auto & center : centers)
+        {
+            if (dist_sq(center, DOORS[i]) < dist_sq(*nearest, DOORS[i]))
+                nearest = &center;
+        }
+
+        // left and right doors go straight in along the x-axis first, top and bottom doors along the y-axis
+        carve_hallway(tiles, DOORS[i], *nearest, i % 2 == 0);
+    }
+
+    // with fewer than 3 rooms, or rooms whose centers are all on one line, the triangulation has no triangles,
+    // so the map comes back without any hallways between its rooms
+    // chain the rooms together in order of their centers instead, so the doors can still reach every room
+    rtrnval->hall_edges = generator.get_hall_edges();
+    if (rtrnval->hall_edges.empty() && centers.size() > 1)
+    {
+        vector<uint32_t> order(centers.size());
+        iota(order.begin(), order.end(), 0);
+        sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+        {
+            return centers[a].X < centers[b].X || (centers[a].X == centers[b].X && centers[a].Y < centers[b].Y);
+        });
+
+        for (size_t i = 0; i + 1 < order.size(); ++i)
+        {
+            carve_hallway(tiles, centers[order[i]], centers[order[i + 1]], true);
+            rtrnval->hall_edges.push_back({order[i], order[i + 1]});
+        }
+    }
+
+    // the hallways cut through the walls of the map, so the walls have to be added again
+    tk::dilate_walls(tiles.get_data(), tiles.get_width(), tiles.get_height());
+
+    // everything else is stored in world coordinates
+    const CoordinatePair WORLD_OFFSET = {cx * chunk_size + OFFSET.X, cy * chunk_size + OFFSET.Y};
+    rtrnval->rooms.reserve(generator.get_rooms().size());
+    for (const auto & rp : generator.get_rooms())
+    {
+        rtrnval->rooms.push_back(shift(rp, WORLD_OFFSET));
+    }
+
+    chunks_generated++;
+
+    return rtrnval;
+}
+
+/* Private function
+ * Throws away least recently used chunks until the loaded chunks fit in the budget
+ * The most recently used chunk is never thrown away, even if it doesn't fit by itself
+ */
+void ChunkedWorld::evict()
+{
+    while (memory_usage > memory_budget && lru.size() > 1)
+    {
+        auto entry = chunks.find(lru.back());
+
+        memory_usage -= entry->second.chunk->get_memory_usage();
+        chunks.erase(entry);
+        lru.pop_back();
+
+        chunks_evicted++;
+    }
+}
+
+/* Returns the chunk at (`cx`, `cy`), generating it if it isn't loaded
+ * Either way, it becomes the most recently used chunk
+ */
+std::shared_ptr<const WorldChunk> ChunkedWorld::get_chunk(int32_t cx, int32_t cy)
+{
+    const uint64_t KEY = chunk_key(cx, cy);
+
+    auto found = chunks.find(KEY);
+    if (found != chunks.end())
+    {
+        // move it to the front of the list
+        lru.splice(lru.begin(), lru, found->second.lru_pos);
+        return found->second.chunk;
+    }
+
+    std::shared_ptr<const WorldChunk> rtrnval = generate_chunk(cx, cy);
+
+    lru.push_front(KEY);
+    chunks.insert({KEY, {rtrnval, lru.begin()}});
+    memory_usage += rtrnval->get_memory_usage();
+
+    evict();
+
+    return rtrnval;
+}
+
+/* Returns the tile at (`x`, `y`) in world coordinates
+ * Generates the chunk the tile is in if it isn't loaded
+ */
+uint8_t ChunkedWorld::get_tile(int64_t x, int64_t y)
+{
+    const int64_t CX = floor_div(x, chunk_size);
+    const int64_t CY = floor_div(y, chunk_size);
+
+    std::shared_ptr<const WorldChunk> chunk = get_chunk(CX, CY);
+
+    return chunk->tiles(x - CX * chunk_size, y - CY * chunk_size);
+}
+
+/* Returns whether the chunk at (`cx`, `cy`) is loaded
+ * Doesn't count as using the chunk
+ */
+bool ChunkedWorld::is_loaded(int32_t cx, int32_t cy) const
+{
+    return chunks.count(chunk_key(cx, cy)) != 0;
+}
+
+/* Throws away every loaded chunk
+ * Chunks that are still held by someone else stay valid until they let go of them
+ */
+void ChunkedWorld::clear()
+{
+    chunks.clear();
+    lru.clear();
+    memory_usage = 0;
+}
+
+
+
+// Getters
+// (self explanatory)
+int32_t ChunkedWorld::get_seed() const
+{
+    return world_seed;
+}
+uint16_t ChunkedWorld::get_chunk_size() const
+{
+    return chunk_size;
+}
+size_t ChunkedWorld::get_memory_budget() const
+{
+    return memory_budget;
+}
+size_t ChunkedWorld::get_memory_usage() const
+{
+    return memory_usage;
+}
+size_t ChunkedWorld::get_num_loaded() const
+{
+    return chunks.size();
+}
+uint64_t ChunkedWorld::get_chunks_generated() const
+{
+    return chunks_generated;
+}
+uint64_t ChunkedWorld::get_chunks_evicted() const
+{
+    return chunks_evicted;
+}
@@ -0,0 +1,120 @@
+/* Rosa Knowles
+ * 11/20/2025
+ * Header file for `ChunkedWorld`, a dungeon that is split into square chunks so it can be as big as it needs to be
+ *
+ * Each chunk is its own `DungeonMap`, generated from a seed that only depends on the world seed and the chunk's position,
+ * so a chunk always comes out the same no matter which chunks were generated before it
+ * Neighboring chunks are connected by a door on the border between them. Both chunks work out where the door is
+ * from the same seed, and each one carves a hallway from its side of the door to its nearest room
+ * A chunk whose map has no hallways (too few rooms, or rooms in a line) gets its rooms chained together,
+ * so every room can always be reached from the doors
+ * Chunks are only generated when they are asked for, and the least recently used ones are thrown away
+ * once the chunks that are loaded take up more memory than the budget
+ */
+
+#ifndef CHUNKEDWORLD_H
+#define CHUNKEDWORLD_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include "dungeongen.h"
+
+
+/* Struct that stores a single chunk of a `ChunkedWorld`
+ * The tiles are in chunk coordinates, everything else is in world coordinates
+ * (the tile at (x, y) of the chunk is at (`cx * chunk_size + x`, `cy * chunk_size + y`) in the world)
+ */
+struct WorldChunk
+{
+    // position of the chunk, in chunks
+    int32_t cx;
+    int32_t cy;
+    // seed that was used to generate the chunk's map
+    int32_t seed;
+
+    // `chunk_size` x `chunk_size` tiles
+    ByteMatrix2D tiles;
+    std::vector<RoomPairs> rooms;
+    // hallways between the rooms of this chunk, indices into `rooms`
+    std::vector<HallEdge> hall_edges;
+
+    // bytes held by the chunk
+    size_t get_memory_usage() const;
+};
+
+
+class ChunkedWorld
+{
+    private:
+        int32_t world_seed;
+        uint16_t chunk_size;
+        size_t memory_budget;
+
+        // map that every chunk is generated with, reused so its memory doesn't have to be allocated again for each chunk
+        DungeonMap generator;
+
+        // loaded chunks, most recently used at the front of `lru`
+        // `chunks` maps the key of a chunk (see `chunk_key`) to the chunk and its place in `lru`
+        struct CacheEntry
+        {
+            std::shared_ptr<const WorldChunk> chunk;
+            std::list<uint64_t>::iterator lru_pos;
+        };
+        std::list<uint64_t> lru;
+        std::unordered_map<uint64_t, CacheEntry> chunks;
+        size_t memory_usage = 0;
+
+        uint64_t chunks_generated = 0;
+        uint64_t chunks_evicted = 0;
+
+        // packs the position of a chunk into a single key
+        static uint64_t chunk_key(int32_t cx, int32_t cy);
+        // seed of the chunk at (`cx`, `cy`)
+        int32_t chunk_seed(int32_t cx, int32_t cy, uint32_t attempt) const;
+        // position of the door on the border to the right of (`horizontal` == true) or below the chunk at (`cx`, `cy`)
+        // measured along the border, the door is that tile and the next one
+        uint16_t door_offset(int32_t cx, int32_t cy, bool horizontal) const;
+
+        // generates the chunk at (`cx`, `cy`)
+        std::shared_ptr<WorldChunk> generate_chunk(int32_t cx, int32_t cy);
+        // throws away least recently used chunks until the loaded chunks fit in the budget
+        void evict();
+
+    public:
+        // constructor
+        // every chunk gets `rooms_per_chunk` rooms, with side lengths in [`min_room_len`, `max_room_len`]
+        // `memory_budget` is in bytes, and at least one chunk is always kept loaded
+        // throws an `std::invalid_argument` if the room side lengths aren't valid (see `DungeonMap`), if there are no rooms,
+        // or if `chunk_size` is too small to fit a door in each border
+        ChunkedWorld(int32_t world_seed_arg, uint16_t chunk_size_arg,
+                     uint16_t min_room_len, uint16_t max_room_len, uint32_t rooms_per_chunk,
+                     size_t memory_budget_arg = DEFAULT_CHUNK_MEMORY_BUDGET);
+
+        // returns the chunk at (`cx`, `cy`), generating it if it isn't loaded
+        // the chunk stays valid for as long as the caller holds on to it, even if it gets evicted from the world
+        // throws an `std::runtime_error` if the rooms never fit in a chunk (`chunk_size` is too small for the rooms)
+        std::shared_ptr<const WorldChunk> get_chunk(int32_t cx, int32_t cy);
+        // returns the tile at (`x`, `y`) in world coordinates, generating its chunk if needed
+        uint8_t get_tile(int64_t x, int64_t y);
+        // returns whether the chunk at (`cx`, `cy`) is loaded, without generating it
+        bool is_loaded(int32_t cx, int32_t cy) const;
+        // throws away every loaded chunk
+        void clear();
+
+        // getters
+        int32_t get_seed() const;
+        uint16_t get_chunk_size() const;
+        size_t get_memory_budget() const;
+        // bytes held by every loaded chunk
+        size_t get_memory_usage() const;
+        size_t get_num_loaded() const;
+        uint64_t get_chunks_generated() const;
+        uint64_t get_chunks_evicted() const;
+};
+
+#endif
@@ -0,0 +1,213 @@
+/* Rosa Knowles
+ * 11/22/2025
+ * Definitions for the methods of `CorridorRouter`
+ */
+
+#include "corridorrouter.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <algorithm>
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // the 4 directions a path can step in (right, left, down, up)
+    const int32_t STEP_X[4] = {1, -1, 0, 0};
+    const int32_t STEP_Y[4] = {0, 0, 1, -1};
+};
+
+
+/* Private function
+ * Checks whether (`x`, `y`) is in `room`, or one tile above or to the left of it
+ * A step onto a tile carves it and the tiles to the right and below it, so those steps carve into the room too
+ */
+bool CorridorRouter::near_room(const RoomPairs & room, int64_t x, int64_t y)
+{
+    return x >= (int64_t)room.top_left.X - 1 && x < room.bottom_right.X
+        && y >= (int64_t)room.top_left.Y - 1 && y < room.bottom_right.Y;
+}
+
+/* Gets ready to route hallways on `matrix`
+ * Every tile starts out as empty space, and then the rooms are stamped in a row at a time
+ * The buffers only reallocate if `matrix` has more tiles than any matrix before it
+ */
+void CorridorRouter::reset(const ByteMatrix2D & matrix, const std::vector<RoomPairs> & rooms)
+{
+    using namespace std;
+
+    width = matrix.get_width();
+    height = matrix.get_height();
+
+    const size_t NUM_TILES = (size_t)width * height;
+    costs.assign(NUM_TILES, EMPTY_COST);
+    visited.assign(NUM_TILES, 0);
+    dist.resize(NUM_TILES);
+    came_from.resize(NUM_TILES);
+    stamp = 0;
+    expansions = 0;
+
+    for (const auto & rp : rooms)
+    {
+        const int64_t X_START = max<int64_t>((int64_t)rp.top_left.X - 1, 0);
+        const int64_t X_END = min<int64_t>(rp.bottom_right.X, width);
+        const int64_t Y_START = max<int64_t>((int64_t)rp.top_left.Y - 1, 0);
+        const int64_t Y_END = min<int64_t>(rp.bottom_right.Y, height);
+
+        for (int64_t y = Y_START; y < Y_END; ++y)
+        {
+            memset(costs.data() + y * width + X_START, ROOM_COST, X_END - X_START);
+        }
+    }
+}
+
+/* Finds the cheapest path from the center of `from` to the center of `to` with A*, and carves it into `matrix`
+ * The cost left is estimated as the manhattan distance times `CORRIDOR_COST`,
+ * which never overestimates since that is the cheapest a step can be
+ * Paths stay one tile away from the edges of the matrix, so the hallway and the walls around it always fit
+ * Returns the number of steps in the path
+ */
+size_t CorridorRouter::route(ByteMatrix2D & matrix, const RoomPairs & from, const RoomPairs & to)
+{
+    using namespace std;
+
+    const CoordinatePair START = from.center;
+    const CoordinatePair GOAL = to.center;
+    const size_t START_INDEX = (size_t)START.Y * width + START.X;
+    const size_t GOAL_INDEX = (size_t)GOAL.Y * width + GOAL.X;
+
+    // a path can step onto any tile from (1, 1) to (`width - 3`, `height - 3`)
+    const int64_t MAX_X = (int64_t)width - 3;
+    const int64_t MAX_Y = (int64_t)height - 3;
+
+    auto estimate = [&](int64_t x, int64_t y)
+    {
+        return (uint32_t)(CORRIDOR_COST * (llabs(x - GOAL.X) + llabs(y - GOAL.Y)));
+    };
+
+    // stamps only run out after billions of searches on the same map, but if they do, start them over
+    if (stamp > UINT32_MAX - 2)
+    {
+        fill(visited.begin(), visited.end(), 0);
+        stamp = 0;
+    }
+    stamp += 2;
+
+    // a search that stopped at the goal leaves tiles on the open list
+    for (auto & bucket : buckets)
+    {
+        bucket.clear();
+    }
+
+    dist[START_INDEX] = 0;
+    visited[START_INDEX] = stamp;
+    uint32_t current_f = estimate(START.X, START.Y);
+    buckets[current_f % NUM_BUCKETS].push_back(START_INDEX);
+    size_t num_open = 1;
+
+    while (num_open > 0)
+    {
+        while (buckets[current_f % NUM_BUCKETS].empty())
+            current_f++;
+
+        const size_t T = buckets[current_f % NUM_BUCKETS].back();
+        buckets[current_f % NUM_BUCKETS].pop_back();
+        num_open--;
+
+        // a tile can be on the open list more than once if a cheaper path to it was found later,
+        // but only the cheapest one gets expanded
+        if (visited[T] == stamp + 1)
+            continue;
+        visited[T] = stamp + 1;
+        expansions++;
+
+        if (T == GOAL_INDEX)
+            break;
+
+        const int64_t X = T % width;
+        const int64_t Y = T / width;
+
+        // the step that keeps going in the same direction goes on the open list last, so it comes off first,
+        // which keeps paths straight when there are a few that cost the same
+        const uint8_t LAST_DIR = (T == START_INDEX) ? 0 : came_from[T];
+        for (uint8_t k = 1; k <= 4; ++k)
+        {
+            const uint8_t DIR = (LAST_DIR + k) % 4;
+            const int64_t NX = X + STEP_X[DIR];
+            const int64_t NY = Y + STEP_Y[DIR];
+
+            if (NX < 1 || NY < 1 || NX > MAX_X || NY > MAX_Y)
+                continue;
+
+            const size_t N = (size_t)NY * width + NX;
+            if (visited[N] == stamp + 1)
+                continue;
+
+            // the rooms at either end of the hallway don't count as rooms that are in the way
+            const uint32_t COST = (near_room(from, NX, NY) || near_room(to, NX, NY)) ? CORRIDOR_COST : costs[N];
+            const uint32_t NEW_DIST = dist[T] + COST;
+
+            if (visited[N] != stamp || NEW_DIST < dist[N])
+            {
+                visited[N] = stamp;
+                dist[N] = NEW_DIST;
+                came_from[N] = DIR;
+                buckets[(NEW_DIST + estimate(NX, NY)) % NUM_BUCKETS].push_back(N);
+                num_open++;
+            }
+        }
+    }
+
+    // walk back from the goal, carving as it goes
+    // every tile on the path becomes a corridor, so later hallways are cheaper if they go the same way
+    size_t rtrnval = 0;
+    size_t t = GOAL_INDEX;
+    while (true)
+    {
+        const matrix_dim_t X = t % width;
+        const matrix_dim_t Y = t / width;
+
+        matrix(X, Y) = TILES::FLOOR;
+        matrix(X + 1, Y) = TILES::FLOOR;
+        matrix(X, Y + 1) = TILES::FLOOR;
+        matrix(X + 1, Y + 1) = TILES::FLOOR;
+
+        if (costs[t] == EMPTY_COST)
+            costs[t] = CORRIDOR_COST;
+
+        if (t == START_INDEX)
+            break;
+
+        const uint8_t DIR = came_from[t];
+        t = (size_t)(Y - STEP_Y[DIR]) * width + (X - STEP_X[DIR]);
+        rtrnval++;
+    }
+
+    return rtrnval;
+}
+
+/* Returns the number of bytes held by the buffers
+ * Uses the capacities, since that's what is actually allocated
+ */
+size_t CorridorRouter::get_memory_usage() const
+{
+    size_t rtrnval = costs.capacity() + visited.capacity() * sizeof(uint32_t)
+                   + dist.capacity() * sizeof(uint32_t) + came_from.capacity();
+
+    for (const auto & bucket : buckets)
+    {
+        rtrnval += bucket.capacity() * sizeof(size_t);
+    }
+
+    return rtrnval;
+}
+
+
+
+// Getters
+// (self explanatory)
+uint64_t CorridorRouter::get_expansions() const
+{
+    return expansions;
+}
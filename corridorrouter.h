@@ -0,0 +1,76 @@
+/* Rosa Knowles
+ * 11/22/2025
+ * Header file for `CorridorRouter`, which finds a path for each hallway with A* instead of always using an L shape
+ * Each step of a path costs:
+ *      - `CORRIDOR_COST` onto a tile that a hallway already goes through, so hallways share corridors when they can
+ *      - `EMPTY_COST` onto empty space
+ *      - `ROOM_COST` onto a room the hallway doesn't start or end in, so hallways go around rooms instead of through them
+ * Every cost is a small whole number, so the open list is a bucket queue instead of a heap
+ * Every buffer is kept between searches (and between maps), so routing doesn't allocate once the buffers are big enough
+ * https://en.wikipedia.org/wiki/A*_search_algorithm
+ */
+
+#ifndef CORRIDORROUTER_H
+#define CORRIDORROUTER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "dungeongen.h"
+
+
+class CorridorRouter
+{
+    public:
+        static constexpr uint8_t CORRIDOR_COST = 2;
+        static constexpr uint8_t EMPTY_COST = 3;
+        static constexpr uint8_t ROOM_COST = 48;
+
+    private:
+        // the estimated total cost of a path only goes up by at most `ROOM_COST + CORRIDOR_COST` per step,
+        // so this many buckets are enough to hold every cost that can be on the open list at once
+        static constexpr uint32_t NUM_BUCKETS = ROOM_COST + CORRIDOR_COST + 1;
+
+        matrix_dim_t width = 0;
+        matrix_dim_t height = 0;
+
+        // cost of a step onto each tile, one byte per tile, row by row (same layout as `ByteMatrix2D`)
+        // a hallway is 2 tiles wide, so a step onto (x, y) carves (x, y) to (x + 1, y + 1),
+        // and counts as going into a room if any of those 4 tiles are in it
+        std::vector<uint8_t> costs;
+
+        // `visited[t] == stamp` means tile `t` is on the open list, and `stamp + 1` means it has been expanded
+        // anything else means it hasn't been reached by this search, so nothing needs to be cleared between searches
+        std::vector<uint32_t> visited;
+        uint32_t stamp = 0;
+        // cost of the cheapest path found so far to each tile, and the direction of its last step
+        std::vector<uint32_t> dist;
+        std::vector<uint8_t>  came_from;
+
+        // open list, bucket `f % NUM_BUCKETS` has the tiles whose path cost plus distance left is `f`
+        std::vector<size_t> buckets[NUM_BUCKETS];
+
+        // number of tiles expanded since the last call to `reset`
+        uint64_t expansions = 0;
+
+        // whether (`x`, `y`) is in `room`, or close enough to it that a step onto it would carve into it
+        static bool near_room(const RoomPairs & room, int64_t x, int64_t y);
+
+    public:
+        // gets ready to route hallways on `matrix`, whose rooms are `rooms`
+        // only reallocates if `matrix` is bigger than any matrix before it
+        void reset(const ByteMatrix2D & matrix, const std::vector<RoomPairs> & rooms);
+        // finds the cheapest path from the center of `from` to the center of `to`, and carves it into `matrix` 2 tiles wide
+        // `matrix` has to be the one `reset` was called with
+        // returns the number of steps in the path
+        size_t route(ByteMatrix2D & matrix, const RoomPairs & from, const RoomPairs & to);
+
+        // bytes held by the buffers
+        size_t get_memory_usage() const;
+
+        // getters
+        uint64_t get_expansions() const;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/* Rosa Knowles
+ * 11/03/2025
+ * Definition for a function that generates many dungeon maps at once
+ */
+
+#include "dungeongen.h"
+#include "threadpool.h"
+
+
+/* Generates one `DungeonMap` for each seed in `seeds`
+ * Every map is independent, so each one is generated as its own task on a `ThreadPool`
+ * The maps are returned in the same order as `seeds`
+ * `num_threads` == 0 uses the number of hardware threads
+ */
+std::vector<DungeonMap> generate_batch(uint16_t min_room_len, uint16_t max_room_len, uint32_t num_rooms,
+                                       const std::vector<int32_t> & seeds, unsigned num_threads)
+{
+    using namespace std;
+
+    // construct every map up front, so each task only ever touches its own slot in the vector
+    vector<DungeonMap> maps;
+    maps.reserve(seeds.size());
+    for (size_t i = 0; i < seeds.size(); ++i)
+    {
+        maps.emplace_back(min_room_len, max_room_len, num_rooms);
+    }
+
+    // no point in spinning up threads for a single map
+    if (num_threads == 1 || seeds.size() <= 1)
+    {
+        for (size_t i = 0; i < seeds.size(); ++i)
+        {
+            maps[i].generate(seeds[i]);
+        }
+        return maps;
+    }
+
+    ThreadPool pool(num_threads);
+    pool.parallel_for(seeds.size(), [&](size_t i)
+    {
+        maps[i].generate(seeds[i]);
+    });
+
+    return maps;
+}
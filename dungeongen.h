@@ -14,6 +14,8 @@
 #include <limits>
 // strings! 
 #include <string>
+// forward declarations for `std::ostream`
+#include <iosfwd>
 #include <random>
 #include <vector>
 // mainly used for calculating the circumcircle of a triangle
@@ -23,6 +25,11 @@
 #include <functional>
 #include <unordered_set>
 #include <unordered_map>
+// used for the heap in prim's algorithm
+#include <queue>
+// used for the per-generation arena
+#include <memory>
+#include <memory_resource>
 
 #include "bytematrix2d.h"
 #include "simplegraph.h"
@@ -43,12 +50,33 @@
 // needs to be between 0 and 1
 #define INCLUSION_PROB 0.1567
 
+// default number of random positions tried for a single room before giving up on random placement
+// once a room runs out of attempts, it gets pushed out of the way of the other rooms instead
+// this keeps the time it takes to place the rooms bounded, no matter what the room parameters are
+#define DEFAULT_PLACEMENT_BUDGET 1024
+
 // macro that evaluates the sign of a number
 #define SIGN(x) (std::signbit(x)) ? -1 : 1
 
-// define this if the program is being tested
-// if this is defined, extra info will be printed out from the functions defined in `dungeonmap.cpp`
-#define TESTING
+// size of the first block of the arena that `DungeonMap::generate` allocates its temporary containers from
+// the arena grows to fit bigger maps, so this only needs to be big enough for a typical map
+#define ARENA_INITIAL_SIZE 65536
+
+// smallest number of rows in a band of hallway carving and wall placement when `DungeonMap` has a thread pool
+// smaller bands would spend more time being handed out to threads than being worked on
+#define MIN_BAND_ROWS 64
+
+// number of bands per thread, so a thread that finishes early can pick up more bands
+#define BANDS_PER_THREAD 4
+
+// default number of bytes the loaded chunks of a `ChunkedWorld` can take up before the oldest ones are thrown away
+#define DEFAULT_CHUNK_MEMORY_BUDGET (64 * 1024 * 1024)
+
+// number of seeds a `ChunkedWorld` tries for a chunk before giving up on fitting its rooms in the chunk
+#define CHUNK_GENERATION_ATTEMPTS 16
+
+// size of the buffer used by `DungeonMap::write_to` when writing to a file descriptor
+#define WRITE_BUFFER_SIZE 65536
 
 // SVG DEFINES:
 // scaling of the svg file:
@@ -103,6 +131,7 @@ namespace std
 };
 
 double dist(CoordinatePair x1, CoordinatePair x2);
+int64_t dist_sq(CoordinatePair x1, CoordinatePair x2);
 
 /* Struct that stores the coorindates for a room
 * The 4 coordinates essentially form a bounding box
@@ -131,6 +160,84 @@ struct Triangle
     friend bool operator==(const Triangle & a, const Triangle & b);
 };
 
+/* Struct that stores a hallway between two rooms
+ * `a` and `b` are indices into the list of rooms of a `DungeonMap`
+ */
+struct HallEdge
+{
+    uint32_t a;
+    uint32_t b;
+};
+
+/* Struct that stores what happened during a single call to `DungeonMap::generate`
+ * Timings are wall clock time (from `std::chrono::steady_clock`), in nanoseconds
+ * The stage timings leave out the time spent in the observer, but `total_ns` doesn't
+ */
+struct GenerationStats
+{
+    // time spent in each stage
+    uint64_t rooms_ns = 0;          // placing the rooms and stamping them into the matrix
+    uint64_t triangulation_ns = 0;  // delaunay triangulation of the room centers
+    uint64_t graph_ns = 0;          // turning the triangles into a graph
+    uint64_t mst_ns = 0;            // prim's algorithm
+    uint64_t hallways_ns = 0;       // picking the extra connections and carving the hallways
+    uint64_t carve_ns = 0;          // just the carving and the walls, the part of `hallways_ns` that a thread pool splits up
+    uint64_t total_ns = 0;
+
+    // number of random positions tried while placing the rooms
+    uint64_t placement_attempts = 0;
+    // number of rooms that ran out of attempts and had to be pushed into place
+    uint32_t placement_fallbacks = 0;
+
+    // number of triangles made and thrown away while triangulating (including the ones touching the super triangle)
+    uint64_t triangles_created = 0;
+    uint64_t triangles_destroyed = 0;
+
+    // number of connections in the delaunay graph, the mst, and the hallway graph
+    size_t dt_edges = 0;
+    size_t mst_edges = 0;
+    size_t hall_edges = 0;
+
+    // number of tiles expanded while searching for the paths of the hallways (only with `HallwayMode::ROUTED`)
+    uint64_t route_expansions = 0;
+
+    // number of tiles written while stamping the rooms, carving the hallways, and placing their walls
+    // counted as they're written, so a tile that gets written twice (like a hallway going through a room) counts twice
+    uint64_t tiles_written = 0;
+
+    // estimate of the most memory in use at once, in bytes
+    // added up from the capacities of the containers that are alive at the end of each stage
+    size_t peak_bytes = 0;
+    // bytes handed out by the generation arena (every temporary container comes from there)
+    size_t arena_bytes = 0;
+};
+
+/* The ways `DungeonMap::generate` can carve the hallways
+ */
+enum class HallwayMode : uint8_t
+{
+    L_SHAPED,   // straight along one axis from one room center, then along the other to the other room center
+    ROUTED      // cheapest path that goes around other rooms and shares other hallways (see `corridorrouter.h`)
+};
+
+/* Graph type used for the graphs of rooms (the triangulation, the mst, and the hallways)
+ * Uses sparse storage, since a triangulation only has ~3 connections per room
+ */
+typedef sg::SimpleGraph<CoordinatePair, sg::SparseAdjacency> RoomGraph;
+
+// defined in `observer.h`
+class GenerationObserver;
+struct GenerationEvent;
+// defined in `arena.h`
+class GenerationArena;
+// defined in `tilegrid.h`
+class TileGrid;
+enum class TileStorage : uint8_t;
+// defined in `corridorrouter.h`
+class CorridorRouter;
+// defined in `threadpool.h`
+class ThreadPool;
+
 /* Class that stores the dungeon map
 * Stores a dynamically allocated 2d array, defined in ByteMatrix2D
 */
@@ -139,34 +246,128 @@ class DungeonMap
     private:
         uint16_t max_room_side_len;
         uint16_t min_room_side_len;
-        uint8_t  total_num_rooms;
+        uint32_t total_num_rooms;
 
         std::mt19937            rng;
         std::vector<RoomPairs>  room_coords;
+        // hallways that were placed in the last call to `generate`
+        std::vector<HallEdge>   hall_edges;
+        // seed used in the last call to `generate`
+        int32_t                 current_seed = 0;
+
+        // the tiles of the map, empty (0 x 0) until the first call to `generate`
+        ByteMatrix2D matrix_rep;
+        // the tiles of the map after a call to `compact`, which frees `matrix_rep`
+        std::unique_ptr<TileGrid> compact_tiles;
 
-        ByteMatrix2D * matrix_rep = nullptr;
+        // every temporary container in `generate` (graphs, the triangulation, scratch space) is allocated from here
+        // it's reset at the start of each call, and keeps its memory between calls, so it only grows until it fits the map
+        // held through a pointer since containers point to it, so it can't move when the map does
+        std::unique_ptr<GenerationArena> arena;
+
+        // maximum number of random positions tried for a single room, 0 means there is no limit
+        uint32_t placement_budget = DEFAULT_PLACEMENT_BUDGET;
+
+        // how the hallways get carved
+        HallwayMode hallway_mode = HallwayMode::L_SHAPED;
+        // finds the paths of the hallways with `HallwayMode::ROUTED`, made the first time it's needed
+        // kept between calls to `generate` so its buffers only grow until they fit the map
+        std::unique_ptr<CorridorRouter> router;
+
+        // carves the hallways and places the walls in bands of rows on this pool
+        // not owned by the map, and `nullptr` (everything on the calling thread) by default
+        ThreadPool * pool = nullptr;
+
+        // stats from the last call to `generate`
+        GenerationStats stats;
+
+        // gets sent an event at the end of each stage of `generate`, see `observer.h`
+        // not owned by the map, and `nullptr` (no events) by default
+        GenerationObserver * observer = nullptr;
 
         // private functions that will be called inside of `generate`
-        void place_room(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+        void place_room(int32_t x, int32_t y, int32_t w, int32_t h);
         void generate_rooms();
-        std::vector<Triangle> Bowyer_Watson();
-        sg::SimpleGraph<CoordinatePair> Prim(const sg::SimpleGraph<CoordinatePair> & full_graph);
-        void generate_hallways(const sg::SimpleGraph<CoordinatePair> & hall_graph);
+        // also fills `edges` with every edge of the triangles once, as pairs of indices into `room_coords`
+        std::pmr::vector<Triangle> Bowyer_Watson(std::pmr::vector<std::pair<uint32_t, uint32_t>> & edges);
+        RoomGraph Prim(const RoomGraph & full_graph);
+        // carves a hallway for each of `hall_edges`
+        void generate_hallways();
+        // sends an event to `observer`
+        void notify(GenerationEvent & event) const;
+        // returns row `y` of the tiles, decoding it into `scratch` (`width` bytes) if the map has been compacted
+        const uint8_t * tile_row(matrix_dim_t y, uint8_t * scratch) const;
+        // bytes held by the matrix, rooms and hallways
+        size_t map_memory_usage() const;
 
     public: 
         // constructor
-        DungeonMap(uint16_t min_room_len, uint16_t max_room_len, uint8_t num_rooms);
+        // throws an `std::invalid_argument` if the side lengths aren't valid
+        // `generate` throws an `std::length_error` if the map ends up too big for a `ByteMatrix2D` (see `matrix_dim_t`)
+        DungeonMap(uint16_t min_room_len, uint16_t max_room_len, uint32_t num_rooms);
         // destructor
         ~DungeonMap();
 
+        // maps own their arena, so they can be moved but not copied
+        // moving a map is cheap, since the matrix and arena are just handed over
+        DungeonMap(const DungeonMap &) = delete;
+        DungeonMap & operator=(const DungeonMap &) = delete;
+        DungeonMap(DungeonMap && other) noexcept;
+        DungeonMap & operator=(DungeonMap && other) noexcept;
+
+        // sets the observer for this map, `nullptr` removes it
+        // the observer has to outlive every call to `generate`
+        void set_observer(GenerationObserver * observer_arg);
+        // sets the maximum number of random positions tried for a single room, 0 means there is no limit
+        void set_placement_budget(uint32_t budget);
+        // sets how the hallways get carved, `HallwayMode::L_SHAPED` by default
+        void set_hallway_mode(HallwayMode mode);
+        // sets the thread pool that the hallways are carved on, `nullptr` carves them on the calling thread
+        // the pool has to outlive every call to `generate`, and the map comes out the same either way
+        void set_thread_pool(ThreadPool * pool_arg);
+
         // converts matrix to a string using the tiles
-        std::string as_str();
+        std::string as_str() const;
+        // writes the same text as `as_str` to a stream or a file descriptor, without building a string
+        void write_to(std::ostream & os) const;
+        void write_to(int fd) const;
         // generates the dungeon
+        // a map can be generated any number of times, each call replaces the last map and reuses its memory
         void generate(int32_t seed);
+        // throws away the last map but keeps its memory, see `generate`
+        void reset();
+        // stores the tiles of the finished map in a more compact way (see `tilegrid.h`), for keeping lots of maps around
+        // frees the matrix, the arena and the router, so the next call to `generate` has to allocate them again
+        // does nothing if the map hasn't been generated
+        void compact(TileStorage storage);
+
+        // getters
+        // number of random positions tried while placing the rooms in the last call to `generate`
+        uint64_t get_placement_attempts() const;
+        // number of rooms that ran out of attempts in the last call to `generate`
+        uint32_t get_placement_fallbacks() const;
+        int32_t get_seed() const;
+        const std::vector<RoomPairs> & get_rooms() const;
+        const std::vector<HallEdge> & get_hall_edges() const;
+        // `nullptr` until `generate` has been called, and after `reset` or `compact`
+        const ByteMatrix2D * get_matrix() const;
+        // the tiles after a call to `compact`, `nullptr` if the map hasn't been compacted
+        const TileGrid * get_tile_grid() const;
+        // width and height of the map, whether or not it has been compacted (0 if there is no map)
+        matrix_dim_t get_width() const;
+        matrix_dim_t get_height() const;
+        // timings and counters from the last call to `generate`
+        const GenerationStats & get_stats() const;
 };
 
 // function to generate an svg file from a graph
 // will likely only be used when testing
-void graph_to_svg(const sg::SimpleGraph<CoordinatePair> & graph, std::string filepath);
+void graph_to_svg(const RoomGraph & graph, std::string filepath);
+
+// generates one map per seed on a work-stealing thread pool
+// each map is identical to the one `DungeonMap::generate` makes for the same seed
+// `num_threads` == 0 uses the number of hardware threads
+std::vector<DungeonMap> generate_batch(uint16_t min_room_len, uint16_t max_room_len, uint32_t num_rooms,
+                                       const std::vector<int32_t> & seeds, unsigned num_threads = 0);
 
 #endif
\ No newline at end of file
@@ -4,12 +4,24 @@
  */
 
 #include "dungeongen.h"
+#include "triangulation.h"
+#include "spatialgrid.h"
+#include "tilekernels.h"
+#include "observer.h"
+#include "arena.h"
+#include "tilegrid.h"
+#include "corridorrouter.h"
+#include "threadpool.h"
+
+// used by `DungeonMap::write_to`
+#include <ostream>
+// used for the timings in `GenerationStats`
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
 
-// only include `iostream` if testing
-// otherwise, `iostream` isn't needed
-#ifdef TESTING
-    #include <iostream>
-#endif
 
 
 // Takes in two `CoordinatePair` structs
@@ -19,6 +31,17 @@ double dist(CoordinatePair x1, CoordinatePair x2)
     return sqrt(pow(x1.X - x2.X, 2.0) + pow(x1.Y - x2.Y, 2.0));
 }
 
+// Takes in two `CoordinatePair` structs
+// Returns the squared distance between the two points
+// Exact, and orders pairs of points the same way `dist` does, so it's used for comparisons
+int64_t dist_sq(CoordinatePair x1, CoordinatePair x2)
+{
+    const int64_t DX = (int64_t)x1.X - x2.X;
+    const int64_t DY = (int64_t)x1.Y - x2.Y;
+
+    return DX * DX + DY * DY;
+}
+
 
 /* checks if two `RoomPairs` (a, b) are overlapping
  */
@@ -96,7 +119,7 @@ bool operator==(const Triangle & a, const Triangle & b)
  * Inherits the `ByteMatrix2D` constructor, and forces the side lengths to be equal
  * Calls the constructor for `ByteMatrix2D`, and then forces each element in the matrix to be the empty tile
  */
-DungeonMap::DungeonMap(uint16_t min_room_len, uint16_t max_room_len, uint8_t num_rooms)
+DungeonMap::DungeonMap(uint16_t min_room_len, uint16_t max_room_len, uint32_t num_rooms)
 {
     // stores the maximum side length for a room in the dungeon
     max_room_side_len = max_room_len;
@@ -105,44 +128,270 @@ DungeonMap::DungeonMap(uint16_t min_room_len, uint16_t max_room_len, uint8_t num
     // stores the total number of rooms 
     total_num_rooms = num_rooms;
 
+    // a room needs at least one tile, and the range of room sizes can't be empty
+    if (min_room_len == 0 || min_room_len > max_room_len)
+    {
+        throw std::invalid_argument("Room side lengths must satisfy 0 < min_room_len <= max_room_len, got "
+            + std::to_string(min_room_len) + " and " + std::to_string(max_room_len));
+    }
+
     room_coords = {};
 }
 
-/* Destructor for the `DungeonMap` class
- * Ensures that `matrix_rep` is freed
+/* Destructor, move constructor and move assignment for the `DungeonMap` class
+ * Every member cleans up after itself, but `GenerationArena` is only forward declared in the header,
+ * so these have to be defined here where it is a complete type
+ */
+DungeonMap::~DungeonMap() = default;
+DungeonMap::DungeonMap(DungeonMap && other) noexcept = default;
+DungeonMap & DungeonMap::operator=(DungeonMap && other) noexcept = default;
+
+/* Sets the observer that gets sent an event at the end of each stage of `generate`
+ * The map doesn't own the observer, so it has to outlive every call to `generate`
+ * `nullptr` removes the observer
+ */
+void DungeonMap::set_observer(GenerationObserver * observer_arg)
+{
+    observer = observer_arg;
+}
+
+/* Throws away the last generated map, without freeing any memory
+ * The rooms, hallways, matrix and arena all keep their capacity, so the next call to `generate`
+ * only has to allocate if it makes a bigger map than any before it
+ * `generate` calls this itself, so it only needs to be called to clear a map early
+ */
+void DungeonMap::reset()
+{
+    room_coords.clear();
+    hall_edges.clear();
+    stats = GenerationStats();
+    current_seed = 0;
+
+    // an empty matrix counts as no matrix for `get_matrix`, but keeps its buffer
+    matrix_rep.resize(0, 0);
+    compact_tiles.reset();
+
+    // nothing from the last call to `generate` is still using the arena, so all of it can be handed out again
+    if (arena != nullptr)
+        arena->reset();
+}
+
+/* Stores the tiles of the finished map as a `TileGrid` of the given kind, and frees everything only `generate` needs
+ * A map that is kept around after it has been generated doesn't need its matrix to be writable,
+ * or the memory it used for its temporary containers
+ * Compacting a map that has already been compacted just changes how its tiles are stored
+ */
+void DungeonMap::compact(TileStorage storage)
+{
+    if (compact_tiles != nullptr)
+        matrix_rep = compact_tiles->to_matrix();
+
+    if (get_matrix() == nullptr)
+        return;
+
+    compact_tiles = make_tile_grid(matrix_rep, storage);
+
+    // assigning an empty matrix and vector is what actually gives the memory back
+    matrix_rep = ByteMatrix2D();
+    arena.reset();
+    router.reset();
+    room_coords.shrink_to_fit();
+    hall_edges.shrink_to_fit();
+}
+
+/* Private function
+ * Returns a pointer to row `y` of the tiles
+ * Points straight into the matrix, unless the map has been compacted, in which case the row gets decoded into `scratch`
  */
-DungeonMap::~DungeonMap()
+const uint8_t * DungeonMap::tile_row(matrix_dim_t y, uint8_t * scratch) const
 {
-    if (matrix_rep != nullptr)
-        delete matrix_rep;
+    if (compact_tiles == nullptr)
+        return matrix_rep.row(y);
+
+    compact_tiles->decode_row(y, scratch);
+    return scratch;
+}
+
+/* Private function
+ * Returns the number of bytes held by the map itself (the matrix, rooms and hallways)
+ */
+size_t DungeonMap::map_memory_usage() const
+{
+    return room_coords.capacity() * sizeof(RoomPairs)
+         + hall_edges.capacity() * sizeof(HallEdge)
+         + matrix_rep.get_capacity()
+         + ((compact_tiles != nullptr) ? compact_tiles->get_memory_usage() : 0);
+}
+
+/* Private function
+ * Sends `event` to the observer, if there is one that wants it
+ * Clears the detail pointers for observers that only want a summary
+ */
+void DungeonMap::notify(GenerationEvent & event) const
+{
+    if (observer == nullptr)
+        return;
+
+    const TraceLevel LEVEL = observer->get_level();
+    if (LEVEL == TraceLevel::NONE)
+        return;
+
+    if (LEVEL < TraceLevel::DETAIL)
+    {
+        event.rooms = nullptr;
+        event.triangles = nullptr;
+        event.graph = nullptr;
+        event.matrix = nullptr;
+    }
+
+    observer->on_event(event);
+}
+
+/* Sets the maximum number of random positions tried for a single room
+ * Rooms that run out of attempts get pushed out of the way of the other rooms instead
+ * 0 means there is no limit (rooms are only ever placed randomly)
+ */
+void DungeonMap::set_placement_budget(uint32_t budget)
+{
+    placement_budget = budget;
+}
+
+/* Sets how the hallways get carved
+ * `HallwayMode::ROUTED` makes nicer maps (hallways don't cut through rooms, and share corridors),
+ * but takes longer than `HallwayMode::L_SHAPED`, which is the default
+ */
+void DungeonMap::set_hallway_mode(HallwayMode mode)
+{
+    hallway_mode = mode;
+}
+
+/* Sets the thread pool that the hallways are carved and the walls are placed on
+ * Only worth it for big maps, since small ones don't have enough rows to split into bands
+ * The pool isn't owned by the map, so it has to outlive every call to `generate`
+ */
+void DungeonMap::set_thread_pool(ThreadPool * pool_arg)
+{
+    pool = pool_arg;
 }
 
 
 
 /* Converts matrix to a string using the tile representations of each of the ids in the matrix
- * Actual implementation is very similar to the `as_str` method for the `ByteMatrix2D` class
+ * The tile ids are already ASCII characters, so each row gets copied into the string in one go
+ * The string is sized once up front, so it never needs to reallocate
  */
-std::string DungeonMap::as_str()
+std::string DungeonMap::as_str() const
 {
     using namespace std;
 
-    string rtrnval = "";
+    if (compact_tiles != nullptr)
+        return compact_tiles->as_str();
+
+    if (matrix_rep.get_width() == 0 || matrix_rep.get_height() == 0)
+        return "";
 
-    for (uint16_t i = 0; i < matrix_rep->get_height(); ++i)
+    const size_t WIDTH = matrix_rep.get_width();
+    const size_t HEIGHT = matrix_rep.get_height();
+
+    // every row, plus a newline between each of them
+    string rtrnval;
+    rtrnval.resize((WIDTH + 1) * HEIGHT - 1);
+
+    char * out = &rtrnval[0];
+    for (size_t i = 0; i < HEIGHT; ++i)
+    {
+        memcpy(out, matrix_rep.row(i), WIDTH);
+        out += WIDTH;
+
+        // adds a newline at the end of every row but the last one
+        if (i + 1 < HEIGHT)
+            *out++ = '\n';
+    }
+
+    return rtrnval;
+}
+
+/* Writes the same text as `as_str` to `os`, without building the string first
+ * Each row is written straight out of the matrix
+ */
+void DungeonMap::write_to(std::ostream & os) const
+{
+    if (compact_tiles != nullptr)
     {
-        for (uint16_t j = 0; j < matrix_rep->get_width(); ++j)
+        compact_tiles->write_to(os);
+        return;
+    }
+
+    if (get_matrix() == nullptr)
+        return;
+
+    const size_t WIDTH = matrix_rep.get_width();
+    const size_t HEIGHT = matrix_rep.get_height();
+
+    for (size_t i = 0; i < HEIGHT; ++i)
+    {
+        os.write((const char *)matrix_rep.row(i), WIDTH);
+
+        if (i + 1 < HEIGHT)
+            os.put('\n');
+    }
+}
+
+/* Writes the same text as `as_str` to the file descriptor `fd`, without building the string first
+ * Rows are batched into a fixed size buffer, so a big map only takes a handful of `write` calls
+ * Throws an `std::system_error` if a write fails
+ */
+void DungeonMap::write_to(int fd) const
+{
+    using namespace std;
+
+    const size_t WIDTH = get_width();
+    const size_t HEIGHT = get_height();
+
+    if (WIDTH == 0 || HEIGHT == 0)
+        return;
+
+    // writes out everything in `buffer[0, len)`, retrying on partial writes and interrupts
+    auto flush = [fd](const char * buffer, size_t len)
+    {
+        while (len > 0)
         {
-            const uint8_t VAL = matrix_rep->get(j, i);
+            const ssize_t WRITTEN = ::write(fd, buffer, len);
+            if (WRITTEN < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                throw system_error(errno, generic_category(), "DungeonMap::write_to failed");
+            }
 
-            // i have no idea if i need to cast to char here, better safe than sorry ig
-            rtrnval += char(VAL);
+            buffer += WRITTEN;
+            len -= WRITTEN;
         }
-        // adds a newline at the end of a row
-        rtrnval.append("\n");
+    };
+
+    // always big enough for at least one row and its newline
+    vector<char> buffer(max<size_t>(WRITE_BUFFER_SIZE, WIDTH + 1));
+    size_t used = 0;
+
+    // only used if the map has been compacted
+    vector<uint8_t> scratch((compact_tiles != nullptr) ? WIDTH : 0);
+
+    for (size_t i = 0; i < HEIGHT; ++i)
+    {
+        if (used + WIDTH + 1 > buffer.size())
+        {
+            flush(buffer.data(), used);
+            used = 0;
+        }
+
+        memcpy(buffer.data() + used, tile_row(i, scratch.data()), WIDTH);
+        used += WIDTH;
+
+        if (i + 1 < HEIGHT)
+            buffer[used++] = '\n';
     }
 
-    // removes the last newline in the string, and returns it
-    return rtrnval.erase(rtrnval.size() - 1);
+    flush(buffer.data(), used);
 }
 
 /* Private function
@@ -152,7 +401,7 @@ std::string DungeonMap::as_str()
  * w -> width of room
  * h -> height of room
  */
-void DungeonMap::place_room(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
+void DungeonMap::place_room(int32_t x, int32_t y, int32_t w, int32_t h)
 {
     using namespace std; 
 
@@ -160,10 +409,10 @@ void DungeonMap::place_room(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
     RoomPairs temp;
     // initialize coordinate pairs using struct initializer lists
     temp.top_left = {x, y};
-    temp.top_right = {(uint16_t)(x + w), y};
-    temp.bottom_left = {x , (uint16_t)(y + h)};
-    temp.bottom_right = {(uint16_t)(x + w), (uint16_t)(y + h)};
-    temp.center = {(uint16_t)((x + x + w) / 2), (uint16_t)((y + y + h) / 2)};
+    temp.top_right = {x + w, y};
+    temp.bottom_left = {x , y + h};
+    temp.bottom_right = {x + w, y + h};
+    temp.center = {(x + x + w) / 2, (y + y + h) / 2};
     room_coords.push_back(temp);
 }
 
@@ -188,6 +437,39 @@ void DungeonMap::place_room(uint16_t x, uint16_t y, uint16_t w, uint16_t h)
 
 
 
+// blank namespace b/c this should only be used within this file
+namespace
+{
+    /* Pushes `room` until it doesn't overlap with any of the rooms in `placed_rooms`
+     * Each time it hits a room, it gets moved just past that room's right or bottom edge
+     * (whichever is the shorter move)
+     * Since `room` only ever moves right or down, it can never hit the same room twice,
+     * so this takes at most one step per placed room
+     */
+    RoomPairs separate_room(const SpatialGrid & placed_rooms, RoomPairs room)
+    {
+        int32_t hit = placed_rooms.find_overlap(room);
+
+        while (hit != -1)
+        {
+            const RoomPairs & OTHER = placed_rooms.get_rooms()[hit];
+
+            const int32_t PUSH_X = OTHER.top_right.X + 1 - room.top_left.X;
+            const int32_t PUSH_Y = OTHER.bottom_left.Y + 1 - room.top_left.Y;
+
+            if (PUSH_X <= PUSH_Y)
+                room = shift(room, {PUSH_X, 0});
+            else
+                room = shift(room, {0, PUSH_Y});
+
+            hit = placed_rooms.find_overlap(room);
+        }
+
+        return room;
+    }
+};
+
+
 /* Private Function
  * PART 1
  * Place rooms so they don't overlap
@@ -199,57 +481,63 @@ void DungeonMap::generate_rooms()
 
     // stores the top-left coordinates of the room that the function is currently working on
     // always starts in the top-left corner
-    uint16_t x_coord = 0, y_coord = 0;
+    int32_t x_coord = 0, y_coord = 0;
 
-    for (uint8_t i = 0; i < total_num_rooms; ++i)
+    for (uint32_t i = 0; i < total_num_rooms; ++i)
     {
         // generate random size for the room
-        uint8_t room_width  = rng() % (max_room_side_len - min_room_side_len + 1) + min_room_side_len;
-        uint8_t room_height = rng() % (max_room_side_len - min_room_side_len + 1) + min_room_side_len;
+        uint16_t room_width  = rng() % (max_room_side_len - min_room_side_len + 1) + min_room_side_len;
+        uint16_t room_height = rng() % (max_room_side_len - min_room_side_len + 1) + min_room_side_len;
 
         // add the room to the room vector
         place_room(x_coord, y_coord, room_width, room_height);
     }
 
-    // create a temporary vector to store all shifted room coords
-    vector<RoomPairs> temp_vec = {};
-
     // maximum shift size
     // 3 seems to be the magic number here, any higher and the dungeon isn't garunteed to generate.
     // any lower and the dungeon feels too spread out
     // BUGFIX 10/22/2025:
     // 3 works only if the total number of rooms is greater than or equal to the maximum side length of the room
     // otherwise, we divide by 2 instead
-    const uint16_t MAX_SHIFT = (total_num_rooms >= max_room_side_len) ? 
-        max_room_side_len * total_num_rooms / 3 :
-        max_room_side_len * total_num_rooms / 2;
-
-    // lambda that checks if the box overlaps with any box in a vector of boxes
-    auto box_overlaps = [](vector<RoomPairs> a, RoomPairs b)
+    // with very few small rooms the division rounds down to 0, which would make `rng() % MAX_SHIFT` divide by 0,
+    // so it's always at least 1
+    // the product is done in 64 bits, since lots of big rooms don't fit in 32
+    const uint64_t MAX_SHIFT = max<uint64_t>(1, (total_num_rooms >= max_room_side_len) ? 
+        (uint64_t)max_room_side_len * total_num_rooms / 3 :
+        (uint64_t)max_room_side_len * total_num_rooms / 2);
+
+    // every room ends up somewhere in [0, MAX_SHIFT + max_room_side_len] on both axes
+    const int64_t EXTENT = MAX_SHIFT + max_room_side_len + 1;
+
+    // the map has to fit in a `ByteMatrix2D`, and its coordinates in a `CoordinatePair`, instead of getting cut off
+    // checked before anything is placed, so a map that is too big never gets built at the wrong size
+    const int64_t MAX_SIDE = min<int64_t>(numeric_limits<matrix_dim_t>::max(), numeric_limits<int32_t>::max());
+    if (EXTENT + 2 * PADDING > MAX_SIDE)
     {
-        if (a.size() == 0)
-            return false;
-
-        bool rtrnval = false;
+        const string SIZE = to_string(EXTENT + 2 * PADDING) + " x " + to_string(EXTENT + 2 * PADDING);
+        if (MAX_SIDE == numeric_limits<matrix_dim_t>::max())
+            throw length_error("A " + SIZE + " map is too big for a ByteMatrix2D, build with DUNGEONGEN_WIDE_MATRIX defined for bigger maps");
+        throw length_error("A " + SIZE + " map is too big, coordinates have to fit in 32 bits");
+    }
 
-        for (auto rp : a)
-        {
-            rtrnval = rtrnval || check_overlap(rp, b);
-        }
+    // grid of the rooms that have already been placed, so each overlap check only looks at nearby rooms
+    // the cells are sized so there are about as many cells as rooms, but are never smaller than a room
+    const int32_t CELLS_PER_SIDE = max<int32_t>((int32_t)ceil(sqrt((double)total_num_rooms)), 1);
+    const int32_t CELL_SIZE = max<int64_t>(max_room_side_len + 1, (EXTENT + CELLS_PER_SIDE - 1) / CELLS_PER_SIDE);
+    SpatialGrid placed_rooms({0, 0}, {(int32_t)EXTENT, (int32_t)EXTENT}, CELL_SIZE, arena.get());
 
-        return rtrnval;
-    };
-
-    #ifdef TESTING
-        int rand_count = 0;
-    #endif
+    stats.placement_attempts = 0;
+    stats.placement_fallbacks = 0;
 
     // shift all rooms so they don't overlap with each other
-    for (auto rp : room_coords)
+    for (const auto & rp : room_coords)
     {
         RoomPairs temp_rp;
+        uint32_t room_attempts = 0;
+        bool placed = false;
 
-        do
+        // try random positions until one of them works, or the room runs out of attempts
+        while (placement_budget == 0 || room_attempts < placement_budget)
         {
             // picks a coordinate pair (x, y) such that
             // x and y are in [-MAX_SHIFT, MAX_SHIFT]
@@ -262,24 +550,31 @@ void DungeonMap::generate_rooms()
 
             temp_rp = shift(rp, shifter);
 
-            #ifdef TESTING
-                rand_count++;
-            #endif
+            stats.placement_attempts++;
+            room_attempts++;
 
+            if (!placed_rooms.overlaps_any(temp_rp))
+            {
+                placed = true;
+                break;
+            }
         }
-        while (box_overlaps(temp_vec, temp_rp));
 
-        temp_vec.push_back(temp_rp);
+        // out of attempts, so push the room from its last random position until it fits
+        if (!placed)
+        {
+            temp_rp = separate_room(placed_rooms, temp_rp);
+            stats.placement_fallbacks++;
+        }
+
+        placed_rooms.insert(temp_rp);
 
 
     }
 
-    #ifdef TESTING
-        cout << "Number of repetitions: " << to_string(rand_count) << endl;
-    #endif
 
-    // since `temp_vec` now contains all the rooms such that their positions don't overlap, replace `room_coords` with it
-    room_coords = temp_vec;
+    // since `placed_rooms` now contains all the rooms such that their positions don't overlap, replace `room_coords` with it
+    room_coords.assign(placed_rooms.get_rooms().begin(), placed_rooms.get_rooms().end());
 
     // find the size of the matrix
     CoordinatePair matr_sz = {0, 0};
@@ -297,6 +592,13 @@ void DungeonMap::generate_rooms()
     matr_sz.X += 2 * PADDING;
     matr_sz.Y += 2 * PADDING;
 
+    // rooms that ran out of attempts can get pushed past `EXTENT`, so the real size has to be checked again
+    if ((uint64_t)matr_sz.X > numeric_limits<matrix_dim_t>::max() || (uint64_t)matr_sz.Y > numeric_limits<matrix_dim_t>::max())
+    {
+        throw length_error("A " + to_string(matr_sz.X) + " x " + to_string(matr_sz.Y)
+            + " map is too big for a ByteMatrix2D, build with DUNGEONGEN_WIDE_MATRIX defined for bigger maps");
+    }
+
     CoordinatePair pad_shifter = {PADDING, PADDING};
 
     for (auto & rp : room_coords)
@@ -304,53 +606,28 @@ void DungeonMap::generate_rooms()
         rp = shift(rp, pad_shifter);
     }
 
-    #ifdef TESTING
-        cout << "Matrix size: " << to_string(matr_sz.X) << " * " << to_string(matr_sz.Y) << endl << endl;
-    #endif
 
-    // print room coordinates, used for testing
-    #ifdef TESTING
-        for (auto rp : room_coords)
-        {
-            cout << "(" << to_string(rp.top_left.X) << ", " << to_string(rp.top_left.Y) << "), ";
-            cout << "(" << to_string(rp.top_right.X) << ", " << to_string(rp.top_right.Y) << "), ";
-            cout << "(" << to_string(rp.bottom_left.X) << ", " << to_string(rp.bottom_left.Y) << "), ";
-            cout << "(" << to_string(rp.bottom_right.X) << ", " << to_string(rp.bottom_right.Y) << "), ";
-            cout << "(" << to_string(rp.center.X) << ", " << to_string(rp.center.Y) << ")" << endl;
-        }
-    #endif
 
     // Create and populate matrix!
+    // a map that has been generated before reuses its matrix, which only reallocates if this map is bigger
+    matrix_rep.resize(matr_sz.X, matr_sz.Y);
 
-    matrix_rep = new ByteMatrix2D(matr_sz.X, matr_sz.Y);
+    // shorter name for the matrix
+    ByteMatrix2D & matrix = matrix_rep;
 
     // fill matrix with empty tiles
-    for (uint16_t i = 0; i < matrix_rep->get_width(); ++i)
-    {
-        for (uint16_t j = 0; j < matrix_rep->get_height(); ++j)
-        {
-            matrix_rep->set(i, j, TILES::EMPTY);
-        }
-    }
+    matrix.fill(TILES::EMPTY);
 
     // place rooms in matrix
-    // triple nested for loop makes me want to kill myself lowkey highkey
-    for (auto rp : room_coords)
+    // walls on the outside of the rooms, floors on the inside, a row at a time
+    for (const auto & rp : room_coords)
     {
-        x_coord = rp.top_left.X;
-        y_coord = rp.top_left.Y;
+        const matrix_dim_t W = rp.bottom_right.X - rp.top_left.X;
+        const matrix_dim_t H = rp.bottom_right.Y - rp.top_left.Y;
 
-        for (uint16_t i = 0; i < (rp.bottom_right.Y - y_coord); ++i)
-        {
-            for (uint16_t j = 0; j < (rp.bottom_right.X - x_coord); ++j)
-            {
-                // place walls on the outside of the rooms, floors on the inside
-                if (i * j == 0 || i == rp.bottom_right.Y - y_coord - 1 || j == rp.bottom_right.X - x_coord - 1)
-                    matrix_rep->set(x_coord + j, y_coord + i, TILES::WALL);
-                else
-                    matrix_rep->set(x_coord + j, y_coord + i, TILES::FLOOR);
-            }
-        }
+        matrix.frame_rect(rp.top_left.X, rp.top_left.Y, W, H, TILES::WALL);
+        matrix.fill_rect_interior(rp.top_left.X, rp.top_left.Y, W, H, TILES::FLOOR);
+        stats.tiles_written += (uint64_t)W * H;
     }
 }
 
@@ -359,440 +636,309 @@ void DungeonMap::generate_rooms()
 // blank namespace b/c these should only be used within this file
 namespace
 {
-    // struct that stores an edge (two points)
-    // only used within the bowyer-watson algorithm
-    struct Edge
-    {
-        CoordinatePair a;
-        CoordinatePair b;
-
-        // overloaded equality operator for `Edge` struct
-        friend bool operator==(const Edge & x, const Edge & y)
-        {
-            return (x.a == y.a) && (x.b == y.b);
-        }
-    };
-
     // constant used for floating point comparisons
     const double EPSILON = 1e-4;
+
+    // nanoseconds since `start`, used for the timings in `GenerationStats`
+    uint64_t nanoseconds_since(std::chrono::steady_clock::time_point start)
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now() - start).count();
+    }
 };
 
 
 /* Private Function
  * PART 2
  * Bowyer-Watson algorithm to create Delaunay Triangulation
- * Returns a vector of `Triangle` structs
+ * The actual triangulation is done incrementally by `dt::Triangulation` (see `triangulation.cpp`)
+ * Returns a vector of `Triangle` structs, and fills `edges` with each edge of the triangles once
  */
-std::vector<Triangle> DungeonMap::Bowyer_Watson()
+std::pmr::vector<Triangle> DungeonMap::Bowyer_Watson(std::pmr::vector<std::pair<uint32_t, uint32_t>> & edges)
 {
     // https://paulbourke.net/papers/triangulate/
     using namespace std;
 
     // initialize and fill vertex list
     // the vertex list will contain the center point of all the rooms
-    vector<CoordinatePair> vertex_list;
+    pmr::vector<CoordinatePair> vertex_list(arena.get());
+    vertex_list.reserve(room_coords.size());
 
-    for (auto rp : room_coords)
+    for (const auto & rp : room_coords)
     {
         vertex_list.push_back(rp.center);
     }
 
+    dt::Triangulation triangulation(arena.get());
+    triangulation.triangulate(vertex_list);
 
-    vector<Triangle> triangle_list;
-
-    // DETERMINE SUPER TRIANGLE
-    // From a square of a * b (with a on the x-axis and b on the y-axis), we can construct a super triangle
-    // with a vertex at (-a/2, 0), (a/2, 2b), (3a/2, 0)
-    Triangle super_triangle =
-        // use initializer lists to create each of the vertices
-        { {(-1 * matrix_rep->get_width()) / 2, 0}, 
-        {matrix_rep->get_width() / 2, 2 * matrix_rep->get_height()},
-        {3 * matrix_rep->get_width() / 2, 0} };
+    pmr::vector<Triangle> rtrnval = triangulation.get_triangles();
+    edges = triangulation.get_edges();
 
-    // slap super triangle vertices into the vertex list
-    vertex_list.push_back(super_triangle.p1);
-    vertex_list.push_back(super_triangle.p2);
-    vertex_list.push_back(super_triangle.p3);
+    stats.triangles_created = triangulation.get_faces_created();
+    stats.triangles_destroyed = triangulation.get_faces_destroyed();
+    stats.peak_bytes = max(stats.peak_bytes, map_memory_usage() + triangulation.get_memory_usage()
+                           + vertex_list.capacity() * sizeof(CoordinatePair) + rtrnval.capacity() * sizeof(Triangle)
+                           + edges.capacity() * sizeof(pair<uint32_t, uint32_t>));
 
-    triangle_list.push_back(super_triangle);
+    // return final list of triangles
+    return rtrnval;
+}
 
-    for (auto vertex : vertex_list)
-    {
-        // list that stores valid edges
-        vector<Edge> edge_buffer;
 
-        // list that stores the new collection of triangles after the algorithm removed invalid triangles
-        vector<Triangle> temp_triangle_list = triangle_list; 
 
-        for (auto tr: triangle_list)
-        {
-            // find circumcircle for `tr`
-            // https://en.wikipedia.org/wiki/Circumcircle#Circumcenter_coordinates
-
-            // let p1 = A, p2 = B, p3 = C (from the formula on wikipedia)
-
-            const double DENOMINATOR = 2 * 
-            (
-                (tr.p1.X * (tr.p2.Y - tr.p3.Y)) +
-                (tr.p2.X * (tr.p3.Y - tr.p1.Y)) +
-                (tr.p3.X * (tr.p1.Y - tr.p2.Y))
-            );
-
-            // Calculate X and Y coordinate of the circumcenter
-
-            const double CCX = 
-                (((pow(tr.p1.X, 2.0) + pow(tr.p1.Y, 2.0)) * (tr.p2.Y - tr.p3.Y)) +
-                ((pow(tr.p2.X, 2.0) + pow(tr.p2.Y, 2.0)) * (tr.p3.Y - tr.p1.Y)) +
-                ((pow(tr.p3.X, 2.0) + pow(tr.p3.Y, 2.0)) * (tr.p1.Y - tr.p2.Y))) / DENOMINATOR;
-
-            const double CCY = 
-                (((pow(tr.p1.X, 2.0) + pow(tr.p1.Y, 2.0)) * (tr.p3.X - tr.p2.X)) +
-                ((pow(tr.p2.X, 2.0) + pow(tr.p2.Y, 2.0)) * (tr.p1.X - tr.p3.X)) +
-                ((pow(tr.p3.X, 2.0) + pow(tr.p3.Y, 2.0)) * (tr.p2.X - tr.p1.X))) / DENOMINATOR;
-
-            // Calculate radius
-            // since all three points sit on the circle, the radius will be the distance between the circumcenter and any one of these points
-            // I'm choosing to calculate the distance between the circumcenter and `p1` = A
-            const double CCR = sqrt(pow(tr.p1.X - CCX, 2.0) + pow(tr.p1.Y - CCY, 2.0));
-
-            // check if `vertex` lies within this circle
-            // if the distance between the circumcenter and vetex is less than the circumradius,
-            // it is contained within the circumcircle
-            const double CCR_VERTEX_DIST = sqrt(pow(vertex.X - CCX, 2.0) + pow(vertex.Y - CCY, 2.0));
-
-            // check if distance between the circumcenter and vertex is less than the circumradius
-            if ((CCR_VERTEX_DIST - CCR) <= EPSILON)
-            {
-                // add 3 triangle edges to edge buffer
-                // remove triangle from triangle list
-
-                // make sure the edges are initialzed such that the point with the 
-                // smaller x value is first
-                // should help to ensure edges aren't duplicated
-                Edge e1, e2, e3;
+/* Private Function
+ * PART 3
+ * Prim's algorithm to create Minimum Spanning Tree
+ * Uses a binary heap of candidate edges, weighted by their squared length
+ * Runs in O(E log V), since a triangulation only has ~3V edges
+ * If `full_graph` isn't connected, this creates a minimum spanning forest instead
+ * Returns a `RoomGraph`
+ */
+RoomGraph DungeonMap::Prim(const RoomGraph & full_graph)
+{
+    // https://www.w3schools.com/dsa/dsa_algo_mst_prim.php
+    // https://en.wikipedia.org/wiki/Prim%27s_algorithm
+    
+    using namespace std;
+    using namespace sg;
 
-                // i love spamming if/else blocks!!!!
-                if (tr.p1.X <= tr.p2.X)
-                {
-                    e1.a = tr.p1;
-                    e1.b = tr.p2;
-                }
-                else
-                {
-                    e1.a = tr.p2;
-                    e1.b = tr.p1;
-                }
+    // vector of all coordinate pairs in the graph (vertex list)
+    const pmr::vector<CoordinatePair> & vertex_list = full_graph.get_data_list();
+    const size_t NUM_VERTICES = vertex_list.size();
 
-                if (tr.p2.X <= tr.p3.X)
-                {
-                    e2.a = tr.p2;
-                    e2.b = tr.p3;
-                }
-                else
-                {
-                    e2.a = tr.p3;
-                    e2.b = tr.p2;
-                }
+    // minimum spanning tree
+    // data points initialized from the elements in `full_graph`
+    RoomGraph mst(vertex_list, arena.get());
 
-                if (tr.p1.X <= tr.p3.X)
-                {
-                    e3.a = tr.p1;
-                    e3.b = tr.p3;
-                }
-                else
-                {
-                    e3.a = tr.p3;
-                    e3.b = tr.p1;
-                }
+    if (NUM_VERTICES == 0)
+        return mst;
 
-                edge_buffer.push_back(e1);
-                edge_buffer.push_back(e2);
-                edge_buffer.push_back(e3);
+    // an edge that could be added to the tree
+    // ordered by weight first, and then by index so ties always break the same way
+    struct Candidate
+    {
+        int64_t  weight;
+        uint32_t to;
+        uint32_t from;
 
+        bool operator>(const Candidate & other) const
+        {
+            if (weight != other.weight)
+                return weight > other.weight;
+            if (to != other.to)
+                return to > other.to;
+            return from > other.from;
+        }
+    };
 
-                // remove triangle from triangle list 
-                // use erase-remove idiom -> https://www.geeksforgeeks.org/cpp/erase-remove-idiom-in-cpp/
-                auto logical_end = remove_if
-                (
-                    temp_triangle_list.begin(),
-                    temp_triangle_list.end(),
-                    [tr](Triangle z) { return z == tr; }
-                );
-                temp_triangle_list.erase(logical_end, temp_triangle_list.end());
+    priority_queue<Candidate, pmr::vector<Candidate>, greater<Candidate>> heap{greater<Candidate>(), pmr::vector<Candidate>(arena.get())};
+    pmr::vector<uint8_t> explored(NUM_VERTICES, 0, arena.get());
 
-            }
+    // pushes every edge from `vertex` to an unexplored vertex onto the heap
+    auto explore = [&](uint32_t vertex)
+    {
+        explored[vertex] = 1;
 
+        for (uint32_t other : full_graph.neighbors(vertex))
+        {
+            if (!explored[other])
+                heap.push({dist_sq(vertex_list[vertex], vertex_list[other]), other, vertex});
         }
+    };
 
-        // update original triangle list from the temporary list
-        triangle_list.clear();
-        triangle_list = move(temp_triangle_list);
+    // the starting vertex is arbitrary, so every unexplored vertex gets a turn
+    // (only the first one does anything unless the graph is disconnected)
+    for (uint32_t root = 0; root < NUM_VERTICES; ++root)
+    {
+        if (explored[root])
+            continue;
 
-        // delete all doubly specified edges from edge buffer -> leaves only edges for enclosing polygon!!!
-        // this section of the code is probably very inefficient but idgaf
-        // c++ is like... fast. so my code being shitty doesn't actually matter!! :3
+        explore(root);
 
-        // lambda that checks if an edge is contained within the list more than once
-        auto check_if_edge_doubly_specified = [edge_buffer](Edge z)
+        while (!heap.empty())
         {
-            uint8_t count = 0;
+            // find the connection with the minimum weight
+            const Candidate MINIMUM = heap.top();
+            heap.pop();
 
-            for (auto a : edge_buffer)
-            {
-                if (a == z)
-                    count++;
+            // both ends were already explored, so this would create a cycle
+            if (explored[MINIMUM.to])
+                continue;
 
-                if (count > 1)
-                    return true;
-            }
-
-            return false;
-        };
-
-        // erase-remove idiom here!!
-        auto logical_end = remove_if
-        (
-            edge_buffer.begin(),
-            edge_buffer.end(),
-            check_if_edge_doubly_specified
-        );
-        edge_buffer.erase(logical_end, edge_buffer.end());
+            mst.mod_connection_at(MINIMUM.from, MINIMUM.to, CONNECTED);
+            explore(MINIMUM.to);
+        }
+    }
 
+    // return minimum spanning tree
+    return mst;
+}
 
-        // print edge buffer if testing
-        #ifdef TESTING
-            cout << "EDGE BUFFER:" << endl;
-            for (auto e : edge_buffer)
-            {
-                cout << "(" << e.a.X << ", " << e.a.Y << ") <--> ("
-                << e.b.X << ", " << e.b.Y << ")" << endl;
-            }
-        #endif
 
-        // add to triangle list all triangles formed between the point and the edges of the enclosing polygon
-        for (auto e : edge_buffer)
-        {
-            Triangle temp;
-            temp.p1 = e.a;
-            temp.p2 = e.b;
-            temp.p3 = vertex;
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // rectangle of tiles, from (`x0`, `y0`) up to but not including (`x1`, `y1`)
+    struct TileRect
+    {
+        int64_t x0;
+        int64_t y0;
+        int64_t x1;
+        int64_t y1;
+    };
 
-            triangle_list.push_back(temp);
-        }
+    /* Returns the tiles on a line from `from` toward `to`, including `from` but not `to`, as [first, last + 1)
+     * The range is empty if `from` and `to` are the same
+     */
+    std::pair<int64_t, int64_t> span_toward(int64_t from, int64_t to)
+    {
+        if (to >= from)
+            return {from, to};
+        return {to + 1, from + 1};
     }
 
-    // remove triangles that use supertriangle vertices
-    vector<Triangle> finished_triangle_list;
-
-    for (auto tr : triangle_list)
+    /* Fills `rects` with the 2 rectangles of floor that make up an L shaped hallway from `vertex` to `c`
+     * The hallway goes along the axis that `vertex` and `c` are furthest apart on first, 2 tiles wide,
+     * and then turns at `c`'s row or column
+     * Either rectangle can be empty
+     */
+    void l_shaped_hallway(const CoordinatePair & vertex, const CoordinatePair & c, TileRect rects[2])
     {
-        // only add triangle to the triangle list if it doesn't contain any of the 
-        // vertices for the super triangle
-        if (tr.p1 != super_triangle.p1 && tr.p1 != super_triangle.p2 && tr.p1 != super_triangle.p3 &&
-            tr.p2 != super_triangle.p1 && tr.p2 != super_triangle.p2 && tr.p2 != super_triangle.p3 &&
-            tr.p3 != super_triangle.p1 && tr.p3 != super_triangle.p2 && tr.p3 != super_triangle.p3)
+        using namespace std;
+
+        const auto [X_FIRST, X_LAST] = span_toward(vertex.X, c.X);
+        const auto [Y_FIRST, Y_LAST] = span_toward(vertex.Y, c.Y);
+
+        // determine whether or not `c` is placed to the side or above `vertex`
+        if (abs(vertex.X - c.X) >= abs(vertex.Y - c.Y))
         {
-            finished_triangle_list.push_back(tr);
+            rects[0] = {X_FIRST, vertex.Y, X_LAST, (int64_t)vertex.Y + 2};
+            rects[1] = {c.X, Y_FIRST, (int64_t)c.X + 2, Y_LAST};
+        }
+        else
+        {
+            rects[0] = {vertex.X, Y_FIRST, (int64_t)vertex.X + 2, Y_LAST};
+            rects[1] = {X_FIRST, c.Y, X_LAST, (int64_t)c.Y + 2};
         }
     }
-
-
-    // return final list of triangles
-    return finished_triangle_list;
-}
-
+};
 
 
 /* Private Function
  * PART 3
- * Prim's algorithm to create Minimum Spanning Tree
- * Returns an `sg::SimpleGraph<CoordinatePair>`
+ * Generate Hallways using the connections in `hall_edges`
+ * With `HallwayMode::L_SHAPED`, each hallway goes straight along one axis and then the other,
+ * and with `HallwayMode::ROUTED`, `router` finds a path for each one (see `corridorrouter.cpp`)
+ * With a thread pool, the matrix is split into bands of rows, and each band only carves the parts of the hallways in it,
+ * so no two threads ever write to the same tile
  */
-sg::SimpleGraph<CoordinatePair> DungeonMap::Prim(const sg::SimpleGraph<CoordinatePair> & full_graph)
+void DungeonMap::generate_hallways()
 {
-    // https://www.w3schools.com/dsa/dsa_algo_mst_prim.php
-    // https://en.wikipedia.org/wiki/Prim%27s_algorithm
-
     using namespace std;
-    using namespace sg;
-
-    // vertex that we can treat as a null value since it will, in practice, never be used in a practical situation
-    const CoordinatePair VERTEX_NULL = {INT32_MIN, INT32_MIN};
 
+    // shorter name for the matrix
+    // hallways run between room centers, which are at least `PADDING` tiles away from the edge,
+    // so every coordinate here is in bounds
+    const auto CARVE_START = chrono::steady_clock::now();
 
-    // vector of all coordinate pairs in the graph (vertex list)
-    vector<CoordinatePair> vertex_list = full_graph.get_data_list();
-    // hashmap of all coordinate pairs in the graph and their connections
-    unordered_map<CoordinatePair, vector<CoordinatePair>> connections = full_graph.get_connections();
+    ByteMatrix2D & matrix = matrix_rep;
+    const size_t HEIGHT = matrix.get_height();
 
-    // minimum spanning tree
-    // data points initialized from the elements in `full_graph`
-    SimpleGraph<CoordinatePair> mst(vertex_list);
-    
-    unordered_set<CoordinatePair> explored_vertices;
-    // initialize set of unexplored vertices using the vertex list
-    unordered_set<CoordinatePair> unexplored_vertices(vertex_list.begin(), vertex_list.end());
+    size_t num_bands = 1;
+    if (pool != nullptr)
+        num_bands = max<size_t>(1, min<size_t>((size_t)pool->size() * BANDS_PER_THREAD, HEIGHT / MIN_BAND_ROWS));
 
-    // get starting vertex
-    // this is arbitrary, so we will just pick the first element in the vertex list
-    CoordinatePair starting_vertex = vertex_list.at(0);
-    unexplored_vertices.erase(starting_vertex);
-    explored_vertices.insert(starting_vertex);
+    // first row of band `band`, the last band ends at `HEIGHT`
+    auto band_start = [&](size_t band) { return (int64_t)(HEIGHT * band / num_bands); };
+    // band that row `y` is in
+    auto band_of = [&](int64_t y) { return min((size_t)(((y + 1) * num_bands - 1) / HEIGHT), num_bands - 1); };
 
-    while (unexplored_vertices.size() > 0)
+    if (hallway_mode == HallwayMode::ROUTED)
     {
-        // find the connection with the minimum weight 
-        Edge minimum_connection;
-        double minimum_weight = DOUBLE_INF;
+        // every path depends on the hallways carved before it, so these can't be split up
+        if (router == nullptr)
+            router = make_unique<CorridorRouter>();
 
-        for (const auto & vertex : explored_vertices)
+        router->reset(matrix, room_coords);
+        for (const auto & he : hall_edges)
         {
-            // iterate through each of the points that connect to `vertex`
-            for (const auto & cp : connections.at(vertex))
-            {
-                // only consider a connection if `cp` has not been explored
-                if (unexplored_vertices.find(cp) != unexplored_vertices.end())
-                {
-                    // calculate the distance between `vertex` and `cp`
-                    // this will be our weight
-                    double temp_weight = dist(vertex, cp);
-
-                    // if a new minimum weight has been found, save it!
-                    if (temp_weight < minimum_weight)
-                    {
-                        minimum_weight = temp_weight;
-                        minimum_connection.a = vertex;
-                        minimum_connection.b = cp;
-                    }
-                }
-            }
-
+            // every tile on the path carves a 2 x 2 square, and the path has one more tile than it has steps
+            stats.tiles_written += 4 * (router->route(matrix, room_coords[he.a], room_coords[he.b]) + 1);
         }
 
-        // move the unexplored point in the new connection from
-        // the set of unexplored vertices to the set of explored vertices
-        unexplored_vertices.erase(minimum_connection.b);
-        explored_vertices.insert(minimum_connection.b);
-
-        mst.mod_connection(minimum_connection.a, minimum_connection.b, CONNECTED);
+        stats.route_expansions = router->get_expansions();
     }
+    else
+    {
+        pmr::memory_resource * resource = arena.get();
 
+        // each hallway is 2 rectangles
+        pmr::vector<TileRect> rects(2 * hall_edges.size(), resource);
+        for (size_t i = 0; i < hall_edges.size(); ++i)
+        {
+            l_shaped_hallway(room_coords[hall_edges[i].a].center, room_coords[hall_edges[i].b].center, &rects[2 * i]);
+        }
 
-    // return minimum spanning tree
-    return mst;    
-}
-
-
-/* Private Function
- * PART 3
- * Generate Hallways using the connections in the graph passed into this function
- * Kind of a very inefficient function, but technology is advanced enough for me to not gaf
- */
-void DungeonMap::generate_hallways(const sg::SimpleGraph<CoordinatePair> & hall_graph)
-{
-    using namespace std;
+        // group the rectangles by the bands they overlap
+        // `band_rects[band_offsets[band]]` up to `band_rects[band_offsets[band + 1]]` are the rectangles in `band`
+        pmr::vector<uint32_t> band_offsets(num_bands + 1, 0, resource);
+        for (const auto & r : rects)
+        {
+            if (r.x0 >= r.x1 || r.y0 >= r.y1)
+                continue;
+            for (size_t band = band_of(r.y0); band <= band_of(r.y1 - 1); ++band)
+                band_offsets[band + 1]++;
+            // the bands split up the rows of a rectangle without overlapping, so every tile in it gets written once
+            stats.tiles_written += (uint64_t)(r.x1 - r.x0) * (r.y1 - r.y0);
+        }
+        for (size_t band = 0; band < num_bands; ++band)
+        {
+            band_offsets[band + 1] += band_offsets[band];
+        }
 
-    // get map of connections 
-    unordered_map<CoordinatePair, vector<CoordinatePair>> all_connections = hall_graph.get_connections();
-    // get list of vertices
-    vector<CoordinatePair> vertex_list = hall_graph.get_data_list();
+        pmr::vector<uint32_t> band_rects(band_offsets[num_bands], resource);
+        pmr::vector<uint32_t> next_slot(band_offsets.begin(), band_offsets.end() - 1, resource);
+        for (uint32_t i = 0; i < rects.size(); ++i)
+        {
+            const TileRect & r = rects[i];
+            if (r.x0 >= r.x1 || r.y0 >= r.y1)
+                continue;
+            for (size_t band = band_of(r.y0); band <= band_of(r.y1 - 1); ++band)
+                band_rects[next_slot[band]++] = i;
+        }
 
-    // setup the floors for each of the hallways
-    for (const auto & vertex : vertex_list)
-    {
-        // iterate through each connection for the vertex
-        for (const auto & c : all_connections.at(vertex))
+        // setup the floors for the part of each hallway in `band`, a row of a rectangle at a time
+        auto carve_band = [&](size_t band)
         {
-            // determine whether or not `c` is placed to the side or above `vertex`
-            bool to_the_side = abs(vertex.X - c.X) >= abs(vertex.Y - c.Y);
-
-            // store the distance between `vertex` and `c`
-            CoordinatePair distance_vector;
-            distance_vector.X = c.X - vertex.X;
-            distance_vector.Y = c.Y - vertex.Y;
-
-            // store the current position
-            // we start at `vertex`
-            CoordinatePair current_pos;
-            current_pos.X = vertex.X;
-            current_pos.Y = vertex.Y;
-
-            // array that describes how the loop should place the hallway
-            int32_t movements[2];
-            if (to_the_side)
-            {
-                movements[0] = distance_vector.X;
-                movements[1] = distance_vector.Y; 
-            }
-            else
-            {
-                movements[0] = distance_vector.Y;
-                movements[1] = distance_vector.X;
-            }
+            const int64_t BAND_Y0 = band_start(band);
+            const int64_t BAND_Y1 = band_start(band + 1);
 
-            // insert hallway into matrix
-            // does two iterations, once for the x-direction, once for the y-direction
-            for (uint16_t iteration = 0; iteration < 2; ++iteration)
+            for (uint32_t slot = band_offsets[band]; slot < band_offsets[band + 1]; ++slot)
             {
-                // this looks gross but it works!!
-                for (uint16_t i = 0; i < abs(movements[iteration]); ++i)
+                const TileRect & r = rects[band_rects[slot]];
+                for (int64_t y = max(r.y0, BAND_Y0); y < min(r.y1, BAND_Y1); ++y)
                 {
-                    matrix_rep->set(current_pos.X, current_pos.Y, TILES::FLOOR);
-                    if ((to_the_side && iteration == 0) || (!to_the_side && iteration != 0))
-                    {
-                        matrix_rep->set(current_pos.X, current_pos.Y + 1, TILES::FLOOR);
-                        current_pos.X += SIGN(movements[iteration]);
-                    }
-                    else
-                    {
-                        matrix_rep->set(current_pos.X + 1, current_pos.Y, TILES::FLOOR);
-                        current_pos.Y += SIGN(movements[iteration]);
-                    }
+                    fill_n(matrix.row((matrix_dim_t)y) + r.x0, r.x1 - r.x0, TILES::FLOOR);
                 }
-
             }
+        };
 
-
-            // remove `vertex` from the connection vector for `c`
-            auto pos = find(all_connections.at(c).begin(), all_connections.at(c).end(), vertex);
-            if (pos != all_connections.at(c).end())
-                all_connections.at(c).erase(pos);
-
-        }
-
+        if (num_bands == 1)
+            carve_band(0);
+        else
+            pool->parallel_for(num_bands, carve_band);
     }
 
     // add walls 
-    // check each empty space to see if it borders a floor
-    // if it borders a floor, add a wall
-    // this block of code is a nesting nightmare. i'm sorry
-    for (uint16_t i = 0; i < matrix_rep->get_width(); ++i)
-    {
-        for (uint16_t j = 0; j < matrix_rep->get_height(); ++j)
-        {
-            if (matrix_rep->get(i, j) == TILES::EMPTY)
-            {
-                uint8_t num_floors = 0;
-
-                for (int8_t a = -1; a <= 1; ++a)
-                {
-                    for (int8_t b = -1; b <= 1; ++b)
-                    {
-                        try
-                        {
-                            if (matrix_rep->get(i + a, j + b) == TILES::FLOOR)
-                                num_floors++;
-                        }
-                        catch(...){}
-                    }
-                }
-
-                if (num_floors > 0)
-                    matrix_rep->set(i, j, TILES::WALL);
-            }
-        }
-    }
-
+    // every empty space that borders a floor (including diagonally) becomes a wall
+    // done a whole row at a time, see `tilekernels.cpp`
+    if (num_bands == 1)
+        stats.tiles_written += tk::dilate_walls(matrix.get_data(), matrix.get_width(), HEIGHT, arena.get());
+    else
+        stats.tiles_written += tk::dilate_walls(matrix.get_data(), matrix.get_width(), HEIGHT, *pool, num_bands, arena.get());
+
+    stats.carve_ns = nanoseconds_since(CARVE_START);
 }
 
 
@@ -807,27 +953,58 @@ void DungeonMap::generate(int32_t seed)
 {
     using namespace std;
 
+    const auto GENERATE_START = chrono::steady_clock::now();
+    auto stage_start = GENERATE_START;
+    // throw away the last map, but keep all of its memory
+    reset();
+    if (arena == nullptr)
+        arena = make_unique<GenerationArena>(ARENA_INITIAL_SIZE);
+    pmr::memory_resource * resource = arena.get();
+
     // setup random number generator (including setting its seed)
     rng = mt19937(seed);
+    current_seed = seed;
 
     // generate empty rooms w/o hallways
     generate_rooms();
 
+    stats.rooms_ns = nanoseconds_since(stage_start);
+    stats.peak_bytes = map_memory_usage();
+
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::ROOMS_PLACED, seed};
+        event.count = room_coords.size();
+        event.placement_attempts = stats.placement_attempts;
+        event.placement_fallbacks = stats.placement_fallbacks;
+        event.matrix_width = matrix_rep.get_width();
+        event.matrix_height = matrix_rep.get_height();
+        event.rooms = &room_coords;
+        event.matrix = &matrix_rep;
+        notify(event);
+    }
+
     // get list of triangles, this will be converted into a graph
-    vector<Triangle> triangle_list = Bowyer_Watson();
-    #ifdef TESTING
-        cout << "TRIANGLE LIST: " << endl;
-        for (auto tr : triangle_list)
-        {
-            cout << "(" << tr.p1.X << ", " << tr.p1.Y << "), (" 
-                 << tr.p2.X << ", " << tr.p2.Y << "), (" 
-                 << tr.p3.X << ", " << tr.p3.Y << ")" << endl;
-        }
-    #endif
+    stage_start = chrono::steady_clock::now();
+    // the edges are indices into `room_coords`
+    pmr::vector<pair<uint32_t, uint32_t>> edge_list(resource);
+    pmr::vector<Triangle> triangle_list = Bowyer_Watson(edge_list);
+    stats.triangulation_ns = nanoseconds_since(stage_start);
+
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::TRIANGULATED, seed};
+        event.count = triangle_list.size();
+        event.triangles = &triangle_list;
+        notify(event);
+    }
 
     // CONVERT LIST OF TRIANGLES INTO A GRAPH
+    stage_start = chrono::steady_clock::now();
+
     // get set of vertices
-    unordered_set<CoordinatePair> set_of_vertices;
+    // the order of the vertices in the graph decides which connections make it into the map, so it has to stay the same
+    pmr::unordered_set<CoordinatePair> set_of_vertices(resource);
     for (auto tr : triangle_list)
     {
         set_of_vertices.insert(tr.p1);
@@ -837,7 +1014,7 @@ void DungeonMap::generate(int32_t seed)
 
     // convert set of vertices to a vector
     // https://stackoverflow.com/questions/42519867/efficiently-moving-contents-of-stdunordered-set-to-stdvector
-    vector<CoordinatePair> vertex_list;
+    pmr::vector<CoordinatePair> vertex_list(resource);
     vertex_list.reserve(set_of_vertices.size());
 
     for (auto it = set_of_vertices.begin(); it != set_of_vertices.end(); )
@@ -845,89 +1022,66 @@ void DungeonMap::generate(int32_t seed)
         vertex_list.push_back(move(set_of_vertices.extract(it++).value())); // ew
     }
 
-    #ifdef TESTING
-        cout << "VERTEX LIST: " << endl;
-        for (auto v : vertex_list)
-        {
-            cout << "(" << v.X << ", " << v.Y << ")" << endl;
-        }
-        cout << "THERE ARE " << to_string(vertex_list.size()) << " VERTICES." << endl; 
-    #endif
 
     // the graph of all vertices, and their connections
-    // formed from the list of triangles
-    sg::SimpleGraph<CoordinatePair> super_graph(vertex_list);
+    // formed from the edges of the triangles
+    RoomGraph super_graph(vertex_list, resource);
     // initialize connections
-    for (auto tr : triangle_list)
+    // the triangulation gives each edge once, so nothing gets connected twice
+    for (const auto & [a, b] : edge_list)
     {
-        // connects each vertex of the triangle `tr`
-        super_graph.mod_connection(tr.p1, tr.p2, sg::CONNECTED);
-        super_graph.mod_connection(tr.p1, tr.p3, sg::CONNECTED);
-        super_graph.mod_connection(tr.p2, tr.p3, sg::CONNECTED);
+        super_graph.mod_connection(room_coords[a].center, room_coords[b].center, sg::CONNECTED);
     }
 
-    // print graph connections if testing
-    #ifdef TESTING
-        // get a hashmap of the connections
-        unordered_map<CoordinatePair, vector<CoordinatePair>> connections_a = super_graph.get_connections();
+    stats.graph_ns = nanoseconds_since(stage_start);
+    stats.dt_edges = super_graph.count_connections();
+    // the set of vertices is emptied by the move above, so it only holds on to its buckets
+    const size_t GRAPH_BYTES = map_memory_usage() + triangle_list.capacity() * sizeof(Triangle)
+                             + edge_list.capacity() * sizeof(pair<uint32_t, uint32_t>)
+                             + vertex_list.capacity() * sizeof(CoordinatePair) + super_graph.get_memory_usage();
+    stats.peak_bytes = max(stats.peak_bytes, GRAPH_BYTES);
 
-        cout << "CONNECTIONS: " << endl;
-        for (const auto [key, value] : connections_a)
-        {
-            cout << "(" << key.X << ", " << key.Y << "): ";
-
-            for (auto cp : value)
-            {
-                cout << "(" << cp.X << ", " << cp.Y << ") ";
-            }
-            cout << endl;
-        }
-    #endif
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::DELAUNAY_GRAPH_BUILT, seed};
+        event.count = super_graph.size();
+        event.graph = &super_graph;
+        notify(event);
+    }
 
     // create minimum spanning tree using prim's algorithm
-    sg::SimpleGraph<CoordinatePair> minimum_spanning_tree = Prim(super_graph);
-
-    // print minimum spanning tree connections if testing
-    #ifdef TESTING
-        // get a hashmap of the connections
-        unordered_map<CoordinatePair, vector<CoordinatePair>> connections_b = minimum_spanning_tree.get_connections();
+    stage_start = chrono::steady_clock::now();
+    RoomGraph minimum_spanning_tree = Prim(super_graph);
+    stats.mst_ns = nanoseconds_since(stage_start);
+    stats.mst_edges = minimum_spanning_tree.count_connections();
 
-        cout << "CONNECTIONS: " << endl;
-        for (const auto [key, value] : connections_b)
-        {
-            cout << "(" << key.X << ", " << key.Y << "): ";
-
-            for (auto cp : value)
-            {
-                cout << "(" << cp.X << ", " << cp.Y << ") ";
-            }
-            cout << endl;
-        }
-    #endif
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::MST_BUILT, seed};
+        event.count = minimum_spanning_tree.size();
+        event.graph = &minimum_spanning_tree;
+        notify(event);
+    }
 
     // create a graph that contains all connections in the minimum spanning tree
     // and contains a small proportion of the connections not found in the minimum spanning tree, but found in the delaunay triangulation graph
-    sg::SimpleGraph<CoordinatePair> partial_graph(vertex_list);
-    // NOTE: "dtg" stands for delaunay triangulation graph
-    unordered_map<CoordinatePair, vector<CoordinatePair>> dtg_connections = super_graph.get_connections();
-    unordered_map<CoordinatePair, vector<CoordinatePair>> mst_connections = minimum_spanning_tree.get_connections();
+    stage_start = chrono::steady_clock::now();
+    RoomGraph partial_graph(vertex_list, resource);
 
     // initialize random generation for probabilites
     uniform_real_distribution<double> urd_prob(0,1);
 
     // add all connections 
-    for (const auto & vertex : vertex_list)
+    // NOTE: all three graphs were made from `vertex_list`, so they share indices
+    for (uint32_t vertex = 0; vertex < vertex_list.size(); ++vertex)
     {
-        // get lists of connections
-        vector<CoordinatePair> vertex_all_connections = dtg_connections.at(vertex);
-        vector<CoordinatePair> vertex_mst_connections = mst_connections.at(vertex);
-
-        for (const auto & c : vertex_all_connections)
+        // NOTE: "dtg" stands for delaunay triangulation graph
+        for (uint32_t c : super_graph.neighbors(vertex))
         {
             // add connection to the partial graph if it is found in the minimum spanning tree
-            if (find(vertex_mst_connections.begin(), vertex_mst_connections.end(), c) != vertex_mst_connections.end())
+            if (minimum_spanning_tree.is_connected_at(vertex, c) == sg::CONNECTED)
             {
-                partial_graph.mod_connection(vertex, c, sg::CONNECTED);
+                partial_graph.mod_connection_at(vertex, c, sg::CONNECTED);
             }
             else
             {
@@ -938,7 +1092,7 @@ void DungeonMap::generate(int32_t seed)
                 // if `determiner` is less than `INCLUSION_PROB`, add the connection to the partial graph
                 if ((determiner - INCLUSION_PROB) <= EPSILON)
                 {
-                    partial_graph.mod_connection(vertex, c, sg::CONNECTED);
+                    partial_graph.mod_connection_at(vertex, c, sg::CONNECTED);
                 }
             }
 
@@ -946,16 +1100,104 @@ void DungeonMap::generate(int32_t seed)
         
     }
 
+    // the observer isn't part of the stage, so the time spent in it gets skipped
+    const uint64_t SELECTION_NS = nanoseconds_since(stage_start);
+
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::HALL_GRAPH_BUILT, seed};
+        event.count = partial_graph.size();
+        event.graph = &partial_graph;
+        notify(event);
+    }
+
+    stage_start = chrono::steady_clock::now();
+
+    // save the hallways as pairs of room indices
+    // the graph's vertices are room centers, which are unique, so they can be matched back up with their rooms
+    pmr::unordered_map<CoordinatePair, uint32_t> room_index(resource);
+    room_index.reserve(room_coords.size());
+    for (uint32_t i = 0; i < room_coords.size(); ++i)
+    {
+        room_index.insert({room_coords[i].center, i});
+    }
+
+    hall_edges.clear();
+    for (uint32_t vertex = 0; vertex < partial_graph.size(); ++vertex)
+    {
+        for (uint32_t c : partial_graph.neighbors(vertex))
+        {
+            if (c > vertex)
+                hall_edges.push_back({room_index.at(partial_graph.at(vertex)), room_index.at(partial_graph.at(c))});
+        }
+    }
+
+    generate_hallways();
+
+    stats.hallways_ns = SELECTION_NS + nanoseconds_since(stage_start);
+    stats.hall_edges = hall_edges.size();
+    stats.peak_bytes = max(stats.peak_bytes, GRAPH_BYTES + minimum_spanning_tree.get_memory_usage()
+                           + partial_graph.get_memory_usage() + hall_edges.capacity() * sizeof(HallEdge)
+                           + ((router != nullptr) ? router->get_memory_usage() : 0));
 
-    // create svg files of the Full Graph and the MST if testing
-    #ifdef TESTING
-        sg::SimpleGraph<CoordinatePair> set_of_all_points(vertex_list);
-        graph_to_svg(set_of_all_points, "out/points.svg");
-        graph_to_svg(super_graph, "out/fullgraph.svg");
-        graph_to_svg(minimum_spanning_tree, "out/mst.svg");
-        graph_to_svg(partial_graph, "out/dungeon_hallways.svg");
-    #endif
+    stats.arena_bytes = arena->get_bytes_used();
+    stats.total_ns = nanoseconds_since(GENERATE_START);
+
+    if (observer != nullptr)
+    {
+        GenerationEvent event{GenerationStage::HALLWAYS_CARVED, seed};
+        event.count = hall_edges.size();
+        event.matrix_width = matrix_rep.get_width();
+        event.matrix_height = matrix_rep.get_height();
+        event.matrix = &matrix_rep;
+        notify(event);
+    }
+
+}
 
-    generate_hallways(partial_graph);
 
-}
\ No newline at end of file
+// Getters
+// (self explanatory)
+uint64_t DungeonMap::get_placement_attempts() const
+{
+    return stats.placement_attempts;
+}
+uint32_t DungeonMap::get_placement_fallbacks() const
+{
+    return stats.placement_fallbacks;
+}
+int32_t DungeonMap::get_seed() const
+{
+    return current_seed;
+}
+const std::vector<RoomPairs> & DungeonMap::get_rooms() const
+{
+    return room_coords;
+}
+const std::vector<HallEdge> & DungeonMap::get_hall_edges() const
+{
+    return hall_edges;
+}
+const ByteMatrix2D * DungeonMap::get_matrix() const
+{
+    if (matrix_rep.get_width() == 0)
+        return nullptr;
+
+    return &matrix_rep;
+}
+const TileGrid * DungeonMap::get_tile_grid() const
+{
+    return compact_tiles.get();
+}
+matrix_dim_t DungeonMap::get_width() const
+{
+    return (compact_tiles != nullptr) ? compact_tiles->get_width() : matrix_rep.get_width();
+}
+matrix_dim_t DungeonMap::get_height() const
+{
+    return (compact_tiles != nullptr) ? compact_tiles->get_height() : matrix_rep.get_height();
+}
+const GenerationStats & DungeonMap::get_stats() const
+{
+    return stats;
+}
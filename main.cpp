@@ -1,6 +1,8 @@
 #include <iostream>
 #include <ctime>
+#include <cstring>
 #include "dungeongen.h"
+#include "observer.h"
 
 using namespace std;
 
@@ -8,9 +10,14 @@ int main(int argc, char ** argv)
 {
     DungeonMap test(6, 10, 15);
 
+    // `--trace` prints every stage of generation, and writes svg files of the graphs to `out/`
+    ConsoleObserver tracer(cout, TraceLevel::DETAIL, "out/");
+    if (argc > 1 && strcmp(argv[1], "--trace") == 0)
+        test.set_observer(&tracer);
+
     test.generate(time(NULL));
 
     cout << test.as_str() << endl;
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,414 @@
+/* Rosa Knowles
+ * 11/16/2025
+ * Definitions for `save_map_file` and the methods of `MapFile`
+ */
+
+#include "mapfile.h"
+#include "tilegrid.h"
+
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+    // no `mmap`, so the file just gets read into memory
+    #include <iterator>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+// the structs get copied straight into the file, so their layout can't change without bumping `mf::VERSION`
+static_assert(sizeof(mf::Header) == 88, "mf::Header has padding in it");
+static_assert(sizeof(RoomPairs) == 40, "RoomPairs has padding in it");
+static_assert(sizeof(HallEdge) == 8, "HallEdge has padding in it");
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // rounds `offset` up to the next multiple of 8
+    uint64_t align_8(uint64_t offset)
+    {
+        return (offset + 7) & ~(uint64_t)7;
+    }
+
+    /* Run length encodes the tiles of `matrix`
+     * Returns the row offset table followed by the runs, ready to be written as the tiles section
+     * The runs are the same as the ones `RleTileGrid` uses
+     */
+    std::vector<uint8_t> encode_tiles(const ByteMatrix2D & matrix)
+    {
+        using namespace std;
+
+        const RleTileGrid GRID(matrix);
+        const vector<uint32_t> & ROW_OFFSETS = GRID.get_row_offsets();
+        const vector<uint8_t> & RUNS = GRID.get_runs();
+        const size_t TABLE_SIZE = ROW_OFFSETS.size() * sizeof(uint32_t);
+
+        vector<uint8_t> rtrnval(TABLE_SIZE + RUNS.size());
+        memcpy(rtrnval.data(), ROW_OFFSETS.data(), TABLE_SIZE);
+        if (!RUNS.empty())
+            memcpy(rtrnval.data() + TABLE_SIZE, RUNS.data(), RUNS.size());
+
+        return rtrnval;
+    }
+};
+
+
+/* Builds the whole file in memory, then writes it out in one go
+ * The sections are small enough (a few bytes per tile at most) that this is simpler than seeking around in the file
+ */
+void save_map_file(const DungeonMap & map, const std::string & path, bool compress_tiles)
+{
+    using namespace std;
+
+    // a compacted map gets decoded back into a matrix first
+    ByteMatrix2D decoded;
+    const ByteMatrix2D * matrix = map.get_matrix();
+    if (matrix == nullptr && map.get_tile_grid() != nullptr)
+    {
+        decoded = map.get_tile_grid()->to_matrix();
+        matrix = &decoded;
+    }
+
+    if (matrix == nullptr)
+        throw invalid_argument("save_map_file: the map hasn't been generated yet");
+
+    const vector<RoomPairs> & rooms = map.get_rooms();
+    const vector<HallEdge> & hall_edges = map.get_hall_edges();
+
+    vector<uint8_t> tiles;
+    if (compress_tiles)
+        tiles = encode_tiles(*matrix);
+
+    mf::Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, mf::MAGIC, sizeof(header.magic));
+    header.version = mf::VERSION;
+    header.byte_order = mf::BYTE_ORDER_MARK;
+    header.flags = compress_tiles ? mf::FLAG_RLE_TILES : 0;
+    header.seed = map.get_seed();
+    header.width = matrix->get_width();
+    header.height = matrix->get_height();
+    header.num_rooms = rooms.size();
+    header.num_hall_edges = hall_edges.size();
+
+    header.tiles_offset = align_8(sizeof(header));
+    header.tiles_size = compress_tiles ? tiles.size() : (uint64_t)header.width * header.height;
+    header.rooms_offset = align_8(header.tiles_offset + header.tiles_size);
+    header.rooms_size = rooms.size() * sizeof(RoomPairs);
+    header.hall_edges_offset = align_8(header.rooms_offset + header.rooms_size);
+    header.hall_edges_size = hall_edges.size() * sizeof(HallEdge);
+
+    // the padding between sections stays 0
+    vector<uint8_t> buffer(header.hall_edges_offset + header.hall_edges_size, 0);
+    memcpy(buffer.data(), &header, sizeof(header));
+
+    if (compress_tiles)
+        memcpy(buffer.data() + header.tiles_offset, tiles.data(), tiles.size());
+    else if (header.tiles_size > 0)
+        memcpy(buffer.data() + header.tiles_offset, matrix->get_data(), header.tiles_size);
+
+    if (!rooms.empty())
+        memcpy(buffer.data() + header.rooms_offset, rooms.data(), header.rooms_size);
+    if (!hall_edges.empty())
+        memcpy(buffer.data() + header.hall_edges_offset, hall_edges.data(), header.hall_edges_size);
+
+    ofstream file(path, ios::binary | ios::trunc);
+    if (!file)
+        throw system_error(errno, generic_category(), "save_map_file: couldn't open " + path);
+
+    file.write((const char *)buffer.data(), buffer.size());
+    file.flush();
+    if (!file)
+        throw system_error(errno, generic_category(), "save_map_file: couldn't write " + path);
+}
+
+
+/* Constructor for the `MapFile` class
+ * Maps the whole file read-only, then checks that everything in it is where the header says it is
+ */
+MapFile::MapFile(const std::string & path)
+{
+    using namespace std;
+
+    #ifdef _WIN32
+        ifstream file(path, ios::binary);
+        if (!file)
+            throw system_error(errno, generic_category(), "MapFile: couldn't open " + path);
+
+        fallback_buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        data = fallback_buffer.data();
+        data_size = fallback_buffer.size();
+    #else
+        const int FD = ::open(path.c_str(), O_RDONLY);
+        if (FD < 0)
+            throw system_error(errno, generic_category(), "MapFile: couldn't open " + path);
+
+        struct stat info;
+        if (::fstat(FD, &info) != 0)
+        {
+            const int ERROR = errno;
+            ::close(FD);
+            throw system_error(ERROR, generic_category(), "MapFile: couldn't stat " + path);
+        }
+
+        // `mmap` doesn't allow empty mappings, and an empty file can't be a map file anyway
+        if ((size_t)info.st_size < sizeof(mf::Header))
+        {
+            ::close(FD);
+            throw runtime_error("MapFile: " + path + " is too small to be a map file");
+        }
+
+        void * mapping = ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+        const int ERROR = errno;
+        // the mapping stays valid after the file is closed
+        ::close(FD);
+
+        if (mapping == MAP_FAILED)
+            throw system_error(ERROR, generic_category(), "MapFile: couldn't map " + path);
+
+        data = (const uint8_t *)mapping;
+        data_size = info.st_size;
+    #endif
+
+    try
+    {
+        validate();
+    }
+    catch (...)
+    {
+        release();
+        throw;
+    }
+}
+
+// destructor
+MapFile::~MapFile()
+{
+    release();
+}
+
+// move constructor
+MapFile::MapFile(MapFile && other) noexcept
+{
+    *this = std::move(other);
+}
+
+// move assignment operator
+MapFile & MapFile::operator=(MapFile && other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    release();
+
+    // moving a vector keeps its buffer, so the pointers into `fallback_buffer` stay valid
+    fallback_buffer = std::move(other.fallback_buffer);
+    data = other.data;
+    data_size = other.data_size;
+    header = other.header;
+    row_offsets = other.row_offsets;
+    runs = other.runs;
+
+    other.data = nullptr;
+    other.data_size = 0;
+    other.header = nullptr;
+    other.row_offsets = nullptr;
+    other.runs = nullptr;
+
+    return *this;
+}
+
+/* Private function
+ * Unmaps the file and resets every pointer into it
+ */
+void MapFile::release()
+{
+    #ifndef _WIN32
+        if (data != nullptr)
+            ::munmap((void *)data, data_size);
+    #endif
+
+    fallback_buffer.clear();
+    data = nullptr;
+    data_size = 0;
+    header = nullptr;
+    row_offsets = nullptr;
+    runs = nullptr;
+}
+
+/* Private function
+ * Checks everything that the accessors rely on, so they never have to read outside of the file
+ * The runs of a row are only checked when the row is decoded
+ */
+void MapFile::validate()
+{
+    using namespace std;
+
+    if (data_size < sizeof(mf::Header))
+        throw runtime_error("MapFile: file is too small to be a map file");
+
+    header = (const mf::Header *)data;
+
+    if (memcmp(header->magic, mf::MAGIC, sizeof(mf::MAGIC)) != 0)
+        throw runtime_error("MapFile: not a map file");
+    if (header->byte_order != mf::BYTE_ORDER_MARK)
+        throw runtime_error("MapFile: map file was written on a machine with a different byte order");
+    if (header->version != mf::VERSION)
+        throw runtime_error("MapFile: unsupported map file version " + to_string(header->version));
+
+    // checks that a section fits in the file and starts on an 8 byte boundary
+    auto check_section = [this](uint64_t offset, uint64_t size, const char * name)
+    {
+        if (offset % 8 != 0 || offset > data_size || size > data_size - offset)
+            throw runtime_error(string("MapFile: ") + name + " section is out of bounds");
+    };
+
+    check_section(header->tiles_offset, header->tiles_size, "tiles");
+    check_section(header->rooms_offset, header->rooms_size, "rooms");
+    check_section(header->hall_edges_offset, header->hall_edges_size, "hallways");
+
+    if (header->rooms_size != (uint64_t)header->num_rooms * sizeof(RoomPairs))
+        throw runtime_error("MapFile: size of the rooms section doesn't match the number of rooms");
+    if (header->hall_edges_size != (uint64_t)header->num_hall_edges * sizeof(HallEdge))
+        throw runtime_error("MapFile: size of the hallways section doesn't match the number of hallways");
+
+    const HallEdge * edges = get_hall_edges();
+    for (uint32_t i = 0; i < header->num_hall_edges; ++i)
+    {
+        if (edges[i].a >= header->num_rooms || edges[i].b >= header->num_rooms)
+            throw runtime_error("MapFile: hallway connects a room that doesn't exist");
+    }
+
+    if (!is_compressed())
+    {
+        if (header->tiles_size != (uint64_t)header->width * header->height)
+            throw runtime_error("MapFile: size of the tiles section doesn't match the size of the map");
+        return;
+    }
+
+    const uint64_t TABLE_SIZE = ((uint64_t)header->height + 1) * sizeof(uint32_t);
+    if (header->tiles_size < TABLE_SIZE)
+        throw runtime_error("MapFile: tiles section is too small for its row table");
+
+    row_offsets = (const uint32_t *)(data + header->tiles_offset);
+    runs = data + header->tiles_offset + TABLE_SIZE;
+
+    // every row has to start after the one before it, and the last one has to end at the end of the section
+    // runs are two bytes each, so every offset has to be even
+    for (uint32_t y = 0; y < header->height; ++y)
+    {
+        if (row_offsets[y] > row_offsets[y + 1] || row_offsets[y] % 2 != 0)
+            throw runtime_error("MapFile: row table of the tiles section is corrupt");
+    }
+    if (row_offsets[header->height] != header->tiles_size - TABLE_SIZE)
+        throw runtime_error("MapFile: row table of the tiles section is corrupt");
+}
+
+
+/* Writes out row `y`, one run at a time
+ * Throws an `std::runtime_error` if the runs of the row don't add up to the width of the map
+ */
+void MapFile::decode_row(uint32_t y, uint8_t * out) const
+{
+    using namespace std;
+
+    if (y >= get_height())
+        throw out_of_range("MapFile::decode_row: row " + to_string(y) + " is outside of the map");
+
+    const size_t WIDTH = header->width;
+
+    if (!is_compressed())
+    {
+        memcpy(out, data + header->tiles_offset + (size_t)y * WIDTH, WIDTH);
+        return;
+    }
+
+    size_t x = 0;
+    for (uint32_t r = row_offsets[y]; r < row_offsets[y + 1]; r += 2)
+    {
+        const size_t LENGTH = (size_t)runs[r + 1] + 1;
+        if (x + LENGTH > WIDTH)
+            throw runtime_error("MapFile::decode_row: row " + to_string(y) + " is longer than the map");
+
+        memset(out + x, runs[r], LENGTH);
+        x += LENGTH;
+    }
+
+    if (x != WIDTH)
+        throw runtime_error("MapFile::decode_row: row " + to_string(y) + " is shorter than the map");
+}
+
+/* Returns the tile at (`x`, `y`)
+ * For run length encoded tiles, this has to walk the runs of the row, so use `decode_row` to read a lot of tiles
+ */
+uint8_t MapFile::get_tile(uint32_t x, uint32_t y) const
+{
+    using namespace std;
+
+    if (x >= get_width() || y >= get_height())
+        throw out_of_range("MapFile::get_tile: (" + to_string(x) + ", " + to_string(y) + ") is outside of the map");
+
+    if (!is_compressed())
+        return data[header->tiles_offset + (size_t)y * header->width + x];
+
+    size_t row_x = 0;
+    for (uint32_t r = row_offsets[y]; r < row_offsets[y + 1]; r += 2)
+    {
+        row_x += (size_t)runs[r + 1] + 1;
+        if (x < row_x)
+            return runs[r];
+    }
+
+    throw runtime_error("MapFile::get_tile: row " + to_string(y) + " is shorter than the map");
+}
+
+
+// Getters
+// (self explanatory)
+int32_t MapFile::get_seed() const
+{
+    return header->seed;
+}
+uint32_t MapFile::get_width() const
+{
+    return header->width;
+}
+uint32_t MapFile::get_height() const
+{
+    return header->height;
+}
+bool MapFile::is_compressed() const
+{
+    return (header->flags & mf::FLAG_RLE_TILES) != 0;
+}
+const uint8_t * MapFile::get_tiles() const
+{
+    if (is_compressed())
+        return nullptr;
+
+    return data + header->tiles_offset;
+}
+uint32_t MapFile::get_num_rooms() const
+{
+    return header->num_rooms;
+}
+const RoomPairs * MapFile::get_rooms() const
+{
+    return (const RoomPairs *)(data + header->rooms_offset);
+}
+uint32_t MapFile::get_num_hall_edges() const
+{
+    return header->num_hall_edges;
+}
+const HallEdge * MapFile::get_hall_edges() const
+{
+    return (const HallEdge *)(data + header->hall_edges_offset);
+}
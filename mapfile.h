@@ -0,0 +1,123 @@
+/* Rosa Knowles
+ * 11/16/2025
+ * Header file for the binary map format, used to save generated dungeons and load them back without regenerating them
+ *
+ * Layout of a map file (everything is stored in the byte order of the machine that wrote it):
+ *      - `mf::Header`
+ *      - tiles section: either the raw tiles (row-major, `width` bytes per row),
+ *        or, if `mf::FLAG_RLE_TILES` is set, a table of `height + 1` uint32 row offsets followed by the runs of every row
+ *        (each run is two bytes: the tile, then the length of the run minus 1, and runs never cross a row)
+ *      - rooms section: `num_rooms` `RoomPairs` structs, exactly as they are stored in memory
+ *      - hallways section: `num_hall_edges` `HallEdge` structs
+ * Every section starts on an 8 byte boundary, so the rooms and hallways can be used straight out of a memory mapped file
+ */
+
+#ifndef MAPFILE_H
+#define MAPFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "dungeongen.h"
+
+
+namespace mf
+{
+    // first 8 bytes of every map file
+    const char MAGIC[8] = {'D', 'G', 'N', 'M', 'A', 'P', '\r', '\n'};
+    // bumped whenever the layout changes
+    const uint32_t VERSION = 1;
+    // written as a uint32, so a file from a machine with a different byte order can be recognized (and rejected)
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    // set if the tiles section is run length encoded
+    const uint32_t FLAG_RLE_TILES = 1;
+
+    struct Header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t byte_order;
+        uint32_t flags;
+        int32_t  seed;
+        uint32_t width;
+        uint32_t height;
+        uint32_t num_rooms;
+        uint32_t num_hall_edges;
+        // offsets are from the start of the file, sizes are in bytes
+        uint64_t tiles_offset;
+        uint64_t tiles_size;
+        uint64_t rooms_offset;
+        uint64_t rooms_size;
+        uint64_t hall_edges_offset;
+        uint64_t hall_edges_size;
+    };
+};
+
+// writes a generated `DungeonMap` to the file at `path`, overwriting it if it already exists
+// `compress_tiles` run length encodes the tiles, which is much smaller since most of a map is empty
+// throws an `std::invalid_argument` if `map` hasn't been generated, and an `std::system_error` if the file can't be written
+void save_map_file(const DungeonMap & map, const std::string & path, bool compress_tiles = true);
+
+
+/* Class that loads a map file written by `save_map_file`
+ * The file is memory mapped and read in place, so loading doesn't depend on the size of the map
+ * (pages only get read from the disk once they are touched)
+ */
+class MapFile
+{
+    private:
+        // start and length of the mapped file
+        const uint8_t * data = nullptr;
+        size_t data_size = 0;
+        // only used on systems without `mmap`, where the file gets read into memory instead
+        std::vector<uint8_t> fallback_buffer;
+
+        const mf::Header * header = nullptr;
+
+        // row offset table and runs of the tiles section, if it is run length encoded
+        const uint32_t * row_offsets = nullptr;
+        const uint8_t * runs = nullptr;
+
+        // checks the header and the bounds of every section, throws an `std::runtime_error` if something is wrong
+        void validate();
+        // unmaps the file (if there is one)
+        void release();
+
+    public:
+        // constructor
+        // throws an `std::system_error` if the file can't be opened or mapped,
+        // and an `std::runtime_error` if it isn't a valid map file
+        explicit MapFile(const std::string & path);
+        // destructor
+        ~MapFile();
+
+        // owns the mapping, so it can be moved but not copied
+        MapFile(const MapFile &) = delete;
+        MapFile & operator=(const MapFile &) = delete;
+        MapFile(MapFile && other) noexcept;
+        MapFile & operator=(MapFile && other) noexcept;
+
+        // returns the tile at (`x`, `y`)
+        // throws an `std::out_of_range` if the coordinates are outside of the map
+        uint8_t get_tile(uint32_t x, uint32_t y) const;
+        // writes the `width` tiles of row `y` to `out`
+        // throws an `std::out_of_range` if `y` is outside of the map
+        void decode_row(uint32_t y, uint8_t * out) const;
+
+        // getters
+        int32_t get_seed() const;
+        uint32_t get_width() const;
+        uint32_t get_height() const;
+        bool is_compressed() const;
+        // the raw tiles (row-major), or `nullptr` if the tiles are run length encoded (use `decode_row` instead)
+        const uint8_t * get_tiles() const;
+        uint32_t get_num_rooms() const;
+        const RoomPairs * get_rooms() const;
+        uint32_t get_num_hall_edges() const;
+        const HallEdge * get_hall_edges() const;
+};
+
+#endif
@@ -0,0 +1,157 @@
+/* Rosa Knowles
+ * 11/17/2025
+ * Definitions for `stage_name` and the methods of `ConsoleObserver`
+ */
+
+#include "observer.h"
+
+#include <ostream>
+
+
+/* Returns the name of `stage` in all caps
+ */
+const char * stage_name(GenerationStage stage)
+{
+    switch (stage)
+    {
+        case GenerationStage::ROOMS_PLACED:         return "ROOMS_PLACED";
+        case GenerationStage::TRIANGULATED:         return "TRIANGULATED";
+        case GenerationStage::DELAUNAY_GRAPH_BUILT: return "DELAUNAY_GRAPH_BUILT";
+        case GenerationStage::MST_BUILT:            return "MST_BUILT";
+        case GenerationStage::HALL_GRAPH_BUILT:     return "HALL_GRAPH_BUILT";
+        case GenerationStage::HALLWAYS_CARVED:      return "HALLWAYS_CARVED";
+    }
+
+    return "UNKNOWN";
+}
+
+
+/* Constructor for the `ConsoleObserver` class
+ * Adds a '/' to the end of `svg_directory_arg` if it doesn't already have one
+ */
+ConsoleObserver::ConsoleObserver(std::ostream & os_arg, TraceLevel level_arg, std::string svg_directory_arg)
+    : os(os_arg), level(level_arg), svg_directory(svg_directory_arg)
+{
+    if (!svg_directory.empty() && svg_directory.back() != '/')
+        svg_directory += '/';
+}
+
+TraceLevel ConsoleObserver::get_level() const
+{
+    return level;
+}
+
+/* Private function
+ * Prints each vertex of `graph`, followed by every vertex it is connected to
+ */
+void ConsoleObserver::print_connections(const RoomGraph & graph)
+{
+    using namespace std;
+
+    os << "CONNECTIONS: " << endl;
+    for (uint32_t i = 0; i < graph.size(); ++i)
+    {
+        const CoordinatePair & key = graph.at(i);
+        os << "(" << key.X << ", " << key.Y << "): ";
+
+        for (const auto & cp : graph.connections_of(i))
+        {
+            os << "(" << cp.X << ", " << cp.Y << ") ";
+        }
+        os << endl;
+    }
+}
+
+/* Private function
+ * Writes `graph` to `svg_directory` + `filename`
+ * Skipped if there is no svg directory, or if the graph is empty (`graph_to_svg` needs at least one point)
+ */
+void ConsoleObserver::write_svg(const RoomGraph & graph, const char * filename)
+{
+    if (svg_directory.empty() || graph.size() == 0)
+        return;
+
+    graph_to_svg(graph, svg_directory + filename);
+}
+
+/* Prints the event
+ * The output is the same as the output of the old `TESTING` define,
+ * with `TraceLevel::SUMMARY` only printing the lines that don't depend on the number of rooms
+ */
+void ConsoleObserver::on_event(const GenerationEvent & event)
+{
+    using namespace std;
+
+    const bool DETAIL = level >= TraceLevel::DETAIL;
+
+    switch (event.stage)
+    {
+        case GenerationStage::ROOMS_PLACED:
+            os << "Number of repetitions: " << to_string(event.placement_attempts) << endl;
+            os << "Number of rooms pushed into place: " << to_string(event.placement_fallbacks) << endl;
+            os << "Matrix size: " << to_string(event.matrix_width) << " * " << to_string(event.matrix_height) << endl << endl;
+
+            if (DETAIL && event.rooms != nullptr)
+            {
+                for (const auto & rp : *event.rooms)
+                {
+                    os << "(" << to_string(rp.top_left.X) << ", " << to_string(rp.top_left.Y) << "), ";
+                    os << "(" << to_string(rp.top_right.X) << ", " << to_string(rp.top_right.Y) << "), ";
+                    os << "(" << to_string(rp.bottom_left.X) << ", " << to_string(rp.bottom_left.Y) << "), ";
+                    os << "(" << to_string(rp.bottom_right.X) << ", " << to_string(rp.bottom_right.Y) << "), ";
+                    os << "(" << to_string(rp.center.X) << ", " << to_string(rp.center.Y) << ")" << endl;
+                }
+            }
+            break;
+
+        case GenerationStage::TRIANGULATED:
+            if (DETAIL && event.triangles != nullptr)
+            {
+                os << "TRIANGLE LIST: " << endl;
+                for (const auto & tr : *event.triangles)
+                {
+                    os << "(" << tr.p1.X << ", " << tr.p1.Y << "), ("
+                       << tr.p2.X << ", " << tr.p2.Y << "), ("
+                       << tr.p3.X << ", " << tr.p3.Y << ")" << endl;
+                }
+            }
+            break;
+
+        case GenerationStage::DELAUNAY_GRAPH_BUILT:
+            if (DETAIL && event.graph != nullptr)
+            {
+                os << "VERTEX LIST: " << endl;
+                for (const auto & v : event.graph->get_data_list())
+                {
+                    os << "(" << v.X << ", " << v.Y << ")" << endl;
+                }
+            }
+            os << "THERE ARE " << to_string(event.count) << " VERTICES." << endl;
+
+            if (DETAIL && event.graph != nullptr)
+            {
+                print_connections(*event.graph);
+
+                // a graph without any connections, so only the points get drawn
+                write_svg(RoomGraph(event.graph->get_data_list()), "points.svg");
+                write_svg(*event.graph, "fullgraph.svg");
+            }
+            break;
+
+        case GenerationStage::MST_BUILT:
+            if (DETAIL && event.graph != nullptr)
+            {
+                print_connections(*event.graph);
+                write_svg(*event.graph, "mst.svg");
+            }
+            break;
+
+        case GenerationStage::HALL_GRAPH_BUILT:
+            if (DETAIL && event.graph != nullptr)
+                write_svg(*event.graph, "dungeon_hallways.svg");
+            break;
+
+        case GenerationStage::HALLWAYS_CARVED:
+            break;
+    }
+}
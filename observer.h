@@ -0,0 +1,121 @@
+/* Rosa Knowles
+ * 11/17/2025
+ * Header file for the tracing interface of `DungeonMap::generate`
+ * A `GenerationObserver` gets one `GenerationEvent` at the end of each stage of generation
+ * Maps don't have an observer by default, in which case no events are built at all
+ */
+
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <iosfwd>
+
+#include "dungeongen.h"
+
+
+// how much information an observer wants
+enum class TraceLevel : uint8_t
+{
+    // no events
+    NONE    = 0,
+    // events only carry counts and sizes
+    SUMMARY = 1,
+    // events also point to the rooms, triangles and graphs of the stage
+    DETAIL  = 2
+};
+
+// the stages of `DungeonMap::generate`, in the order they happen
+enum class GenerationStage : uint8_t
+{
+    // rooms have been placed and stamped into the matrix
+    ROOMS_PLACED,
+    // the delaunay triangulation of the room centers is done
+    TRIANGULATED,
+    // the triangulation has been turned into a graph
+    DELAUNAY_GRAPH_BUILT,
+    // the minimum spanning tree of the delaunay graph is done
+    MST_BUILT,
+    // the graph of the hallways (the mst plus some of the other connections) is done
+    HALL_GRAPH_BUILT,
+    // the hallways have been carved into the matrix
+    HALLWAYS_CARVED
+};
+
+// returns the name of a stage, used for printing
+const char * stage_name(GenerationStage stage);
+
+/* Struct that describes a single stage of generation
+ * The pointers only point to data that is still being used by `generate`,
+ * so they are only valid until `GenerationObserver::on_event` returns
+ */
+struct GenerationEvent
+{
+    GenerationStage stage;
+    // seed passed to `generate`
+    int32_t seed;
+
+    // SUMMARY
+    // filled in for every stage, values that don't apply to a stage are 0
+    // number of rooms (ROOMS_PLACED), triangles (TRIANGULATED), vertices (the graph stages), or hallways (HALLWAYS_CARVED)
+    size_t count = 0;
+    uint64_t placement_attempts = 0;
+    uint32_t placement_fallbacks = 0;
+    matrix_dim_t matrix_width = 0;
+    matrix_dim_t matrix_height = 0;
+
+    // DETAIL
+    // only filled in if the observer asked for `TraceLevel::DETAIL`, `nullptr` otherwise
+    const std::vector<RoomPairs> * rooms = nullptr;         // ROOMS_PLACED
+    const std::pmr::vector<Triangle> * triangles = nullptr; // TRIANGULATED
+    const RoomGraph * graph = nullptr;                      // the graph stages
+    const ByteMatrix2D * matrix = nullptr;                  // ROOMS_PLACED and HALLWAYS_CARVED
+};
+
+/* Interface for anything that wants to watch a map being generated
+ * Events are sent from the thread that called `generate`, so an observer shared by maps
+ * that are generated at the same time has to do its own locking
+ */
+class GenerationObserver
+{
+    public:
+        virtual ~GenerationObserver() {}
+
+        // the most information this observer wants
+        // checked once per stage, so this can change between calls to `generate`
+        virtual TraceLevel get_level() const = 0;
+        // called at the end of each stage
+        virtual void on_event(const GenerationEvent & event) = 0;
+};
+
+
+/* Observer that prints the events to a stream
+ * At `TraceLevel::DETAIL`, this prints the room, triangle, vertex and connection lists,
+ * and writes svg files of the graphs to `svg_directory` (if it isn't empty)
+ * Not thread safe, so it should only be used for one map at a time
+ */
+class ConsoleObserver : public GenerationObserver
+{
+    private:
+        std::ostream & os;
+        TraceLevel level;
+        // directory the svg files get written to, with a trailing '/'
+        std::string svg_directory;
+
+        // prints the connections of every vertex in `graph`
+        void print_connections(const RoomGraph & graph);
+        // writes `graph` to an svg file in `svg_directory`
+        void write_svg(const RoomGraph & graph, const char * filename);
+
+    public:
+        // constructor
+        ConsoleObserver(std::ostream & os_arg, TraceLevel level_arg, std::string svg_directory_arg = "");
+
+        TraceLevel get_level() const override;
+        void on_event(const GenerationEvent & event) override;
+};
+
+#endif
@@ -1,7 +1,12 @@
 /* Rosa Knowles
  * 10/25/2025
  * Header file for a simple implementation of a graph
- * Uses an adjacency matrix
+ * The way the connections are stored is picked with a template parameter:
+ *      - `sg::DenseAdjacency` uses an adjacency matrix (good for small graphs)
+ *      - `sg::SparseAdjacency` uses a sorted list of neighbors for each data point (good for big, sparse graphs)
+ * Everything but the adjacency matrix of `sg::DenseAdjacency` is allocated from a `std::pmr::memory_resource`,
+ * so a graph can be put in an arena (the default resource is the normal heap)
+ * Graphs have value semantics: copying one copies its data and connections, and moving one steals them
  * https://www.w3schools.com/dsa/dsa_data_graphs_implementation.php
  */
 
@@ -10,7 +15,15 @@
 
 #include <vector>
 #include <cstdint>
+#include <cstddef>
+#include <cstring>
 #include <unordered_map>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <limits>
+#include <utility>
+#include <memory_resource>
 
 #include "bytematrix2d.h"
 
@@ -25,39 +38,247 @@ namespace sg
     const uint8_t CONNECTED     = 1;
 
 
-    template <typename T>
-    class SimpleGraph
+    // read-only view of a contiguous list of indices
+    // lets the neighbors of a data point be looped over without copying them into a new vector
+    class IndexSpan
     {
         private:
-            // stores the pairings in the graph
-            ByteMatrix2D * adjacency_matrix = nullptr;
-            // stores the size of the graph
-            size_t graph_size;
-            // stores the actual data in the graph
-            std::vector<T> data_list;
-            // stores the pairings between the data and their index in `data_list`
-            std::unordered_map<T, uint16_t> index_map;
+            const uint32_t * first = nullptr;
+            const uint32_t * last  = nullptr;
 
         public:
+            IndexSpan() {}
+            IndexSpan(const uint32_t * begin_arg, const uint32_t * end_arg) : first(begin_arg), last(end_arg) {}
+
+            const uint32_t * begin() const { return first; }
+            const uint32_t * end() const { return last; }
+            size_t size() const { return last - first; }
+            bool empty() const { return first == last; }
+            uint32_t operator[](size_t i) const { return first[i]; }
+    };
+
+
+    /* Storage policy that keeps the connections in an adjacency matrix
+     * Uses size * size bytes, so it should only be used for small graphs
+     * Capped at the biggest `matrix_dim_t` (65535 unless the matrix is wide) data points by the size of `ByteMatrix2D`
+     */
+    class DenseAdjacency
+    {
+        private:
+            // `matrix.get_width()` is the number of data points
+            // the connection from `a` to `b` is stored at (`b`, `a`), so the connections of `a` are all in row `a`
+            ByteMatrix2D matrix;
+
+        public:
+            // iterates over the connected columns of a single row of the matrix
+            // scans the row's bytes directly, so it never bounds checks or allocates
+            class NeighborIterator
+            {
+                private:
+                    const uint8_t * cells;
+                    uint32_t width;
+                    uint32_t column;
+
+                    // moves `column` forward until it lands on a connection (or the end of the row)
+                    void skip_unconnected()
+                    {
+                        if (column >= width)
+                            return;
+
+                        const void * FOUND = std::memchr(cells + column, CONNECTED, width - column);
+                        column = (FOUND == nullptr) ? width : (uint32_t)((const uint8_t *)FOUND - cells);
+                    }
+
+                public:
+                    NeighborIterator(const uint8_t * cells_arg, uint32_t width_arg, uint32_t column_arg)
+                        : cells(cells_arg), width(width_arg), column(column_arg)
+                    {
+                        skip_unconnected();
+                    }
+
+                    uint32_t operator*() const { return column; }
+                    NeighborIterator & operator++()
+                    {
+                        column++;
+                        skip_unconnected();
+                        return *this;
+                    }
+                    bool operator!=(const NeighborIterator & other) const { return column != other.column; }
+                    bool operator==(const NeighborIterator & other) const { return column == other.column; }
+            };
+
+            // range of the neighbors of a single data point
+            class NeighborRange
+            {
+                private:
+                    const uint8_t * cells;
+                    uint32_t width;
+
+                public:
+                    NeighborRange(const DenseAdjacency * owner, uint32_t row)
+                        : cells(owner->matrix.row(row)), width(owner->matrix.get_width()) {}
+
+                    NeighborIterator begin() const { return NeighborIterator(cells, width, 0); }
+                    NeighborIterator end() const { return NeighborIterator(cells, width, width); }
+            };
+
             // constructor
-            SimpleGraph(std::vector<T> data_list_arg)
+            // the constructor for `ByteMatrix2D` initializes all values to 0 (`NOT_CONNECTED`)
+            // `ByteMatrix2D` always uses the normal heap, so `resource` is ignored
+            // copying, moving and destroying are all handled by `ByteMatrix2D`
+            explicit DenseAdjacency(size_t size, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+            {
+                (void)resource;
+
+                if (size > std::numeric_limits<matrix_dim_t>::max())
+                    throw std::length_error("DenseAdjacency can't store more than " + std::to_string(std::numeric_limits<matrix_dim_t>::max())
+                        + " data points, use SparseAdjacency instead");
+
+                matrix = ByteMatrix2D(size, size);
+            }
+
+            void set(uint32_t a, uint32_t b, uint8_t is_connected)
+            {
+                matrix.set(b, a, is_connected);
+            }
+
+            uint8_t get(uint32_t a, uint32_t b) const
+            {
+                return matrix.get(b, a);
+            }
+
+            NeighborRange neighbors(uint32_t index) const
+            {
+                return NeighborRange(this, index);
+            }
+
+            // bytes used by the matrix
+            size_t get_memory_usage() const
+            {
+                return matrix.get_capacity();
+            }
+    };
+
+
+    /* Storage policy that keeps a sorted list of neighbors for each data point
+     * Uses memory proportional to the number of connections, so it works for graphs of any size
+     */
+    class SparseAdjacency
+    {
+        private:
+            // the inner lists get their memory from the same resource as the outer one
+            std::pmr::vector<std::pmr::vector<uint32_t>> lists;
+
+        public:
+            // constructor
+            explicit SparseAdjacency(size_t size, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+                : lists(size, resource) {}
+
+            void set(uint32_t a, uint32_t b, uint8_t is_connected)
+            {
+                std::pmr::vector<uint32_t> & list = lists.at(a);
+                auto pos = std::lower_bound(list.begin(), list.end(), b);
+                const bool FOUND = pos != list.end() && *pos == b;
+
+                if (is_connected != NOT_CONNECTED && !FOUND)
+                    list.insert(pos, b);
+                else if (is_connected == NOT_CONNECTED && FOUND)
+                    list.erase(pos);
+            }
+
+            uint8_t get(uint32_t a, uint32_t b) const
+            {
+                const std::pmr::vector<uint32_t> & list = lists.at(a);
+                return std::binary_search(list.begin(), list.end(), b) ? CONNECTED : NOT_CONNECTED;
+            }
+
+            IndexSpan neighbors(uint32_t index) const
+            {
+                const std::pmr::vector<uint32_t> & list = lists.at(index);
+                return IndexSpan(list.data(), list.data() + list.size());
+            }
+
+            // bytes reserved by the lists
+            size_t get_memory_usage() const
+            {
+                size_t rtrnval = lists.capacity() * sizeof(std::pmr::vector<uint32_t>);
+                for (const auto & list : lists)
+                {
+                    rtrnval += list.capacity() * sizeof(uint32_t);
+                }
+                return rtrnval;
+            }
+    };
+
+
+    // range that turns a range of indices into the data points stored at those indices
+    // used to loop over the connections of a data point without copying them
+    template <typename T, typename IndexRange>
+    class DataRange
+    {
+        private:
+            using IndexIterator = decltype(std::declval<const IndexRange &>().begin());
+
+            const T * data_list;
+            IndexRange indices;
+
+        public:
+            class Iterator
             {
-                data_list = data_list_arg;
+                private:
+                    const T * data_list;
+                    IndexIterator current;
 
-                graph_size = data_list.size();
+                public:
+                    Iterator(const T * data_list_arg, IndexIterator current_arg)
+                        : data_list(data_list_arg), current(current_arg) {}
 
-                // initializes a new square matrix 
-                // will store which data points are adjacent with each other
-                adjacency_matrix = new ByteMatrix2D(graph_size, graph_size);
+                    const T & operator*() const { return data_list[*current]; }
+                    Iterator & operator++()
+                    {
+                        ++current;
+                        return *this;
+                    }
+                    bool operator!=(const Iterator & other) const { return current != other.current; }
+                    bool operator==(const Iterator & other) const { return current == other.current; }
+            };
+
+            DataRange(const T * data_list_arg, IndexRange indices_arg)
+                : data_list(data_list_arg), indices(indices_arg) {}
+
+            Iterator begin() const { return Iterator(data_list, indices.begin()); }
+            Iterator end() const { return Iterator(data_list, indices.end()); }
+    };
 
-                // NOTE: the constructor for `ByteMatrix2D` initializes all values to 0 for me, 
-                // so I don't need to worry about doing that here
 
+    template <typename T, typename Storage = DenseAdjacency>
+    class SimpleGraph
+    {
+        private:
+            // stores the pairings in the graph
+            Storage adjacency;
+            // stores the actual data in the graph
+            std::pmr::vector<T> data_list;
+            // stores the pairings between the data and their index in `data_list`
+            std::pmr::unordered_map<T, uint32_t> index_map;
+
+        public:
+            // constructor
+            // `data_list_arg` can be any container of `T` with `begin`, `end` and `size` (usually a `std::vector`)
+            // `adjacency` starts out with every pair of data points unconnected
+            // everything the graph allocates comes from `resource`, which has to outlive the graph
+            template <typename Container>
+            explicit SimpleGraph(const Container & data_list_arg, std::pmr::memory_resource * resource = std::pmr::get_default_resource())
+                : adjacency(data_list_arg.size(), resource),
+                  data_list(data_list_arg.begin(), data_list_arg.end(), resource),
+                  index_map(resource)
+            {
                 // initialize `index_map`
                 // makes the assumption that each element in `data_list` is unique
                 // there may be some weird behavior if there are non-unique elements,
                 // but for my purposes, I shouldn't have non-unique elements
-                for (uint16_t i = 0; i < graph_size; ++i)
+                index_map.reserve(data_list.size());
+                for (uint32_t i = 0; i < data_list.size(); ++i)
                 {
                     // pairs a data point with its index for fast searching
                     index_map.insert({data_list.at(i), i});
@@ -65,41 +286,65 @@ namespace sg
 
             }
 
-
-            // Destructor
-            // ensures `adjacency_matrix` is freed
-            ~SimpleGraph()
-            {
-                if (adjacency_matrix != nullptr)
-                    delete adjacency_matrix;
-            }
-
             // GETTERS
-            std::vector<T> get_data_list() const
+            // these return references, so nothing gets copied unless the caller wants a copy
+            const std::pmr::vector<T> & get_data_list() const
             {
                 return data_list;
             }
             size_t size() const
             {
-                // NOTE: `graph_size` is the side length of the matrix
-                return graph_size;
+                // NOTE: the size of the graph is the number of data points
+                return data_list.size();
             }
-            std::unordered_map<T, uint16_t> get_index_map() const
+            const std::pmr::unordered_map<T, uint32_t> & get_index_map() const
             {
                 return index_map;
             }
-            // returns a copy of the adjacency matrix, to prevent any funny business
+            // the data point at `index` in `data_list`
+            const T & at(uint32_t index) const
+            {
+                return data_list.at(index);
+            }
+            // the index of `data` in `data_list`
+            uint32_t index_of(const T & data) const
+            {
+                return index_map.at(data);
+            }
+            // number of connections in the graph (each one is only counted once)
+            size_t count_connections() const
+            {
+                size_t rtrnval = 0;
+                for (uint32_t i = 0; i < data_list.size(); ++i)
+                {
+                    for (uint32_t j : adjacency.neighbors(i))
+                    {
+                        // connections are symmetric, so only count the one going to the higher index
+                        if (j > i)
+                            rtrnval++;
+                    }
+                }
+                return rtrnval;
+            }
+            // rough number of bytes used by the graph
+            // the size of the nodes of `index_map` is a guess, since it depends on the standard library
+            size_t get_memory_usage() const
+            {
+                return adjacency.get_memory_usage()
+                     + data_list.capacity() * sizeof(T)
+                     + index_map.bucket_count() * sizeof(void *)
+                     + index_map.size() * (sizeof(std::pair<const T, uint32_t>) + 2 * sizeof(void *));
+            }
+            // returns a copy of the connections as an adjacency matrix, to prevent any funny business
             ByteMatrix2D get_adjacency_matrix() const
             {
-                ByteMatrix2D rtrnval(graph_size, graph_size);
+                ByteMatrix2D rtrnval(data_list.size(), data_list.size());
 
-                // since the adjacency matrix is diagonally symmetric,
-                // the ordering of `i` and `j` shouldn't matter
-                for (uint16_t i = 0; i < graph_size; ++i)
+                for (uint32_t i = 0; i < data_list.size(); ++i)
                 {
-                    for (uint16_t j = 0; j < graph_size; ++j)
+                    for (uint32_t j : adjacency.neighbors(i))
                     {
-                        rtrnval.set(i, j, adjacency_matrix->get(i, j));
+                        rtrnval.set(i, j, CONNECTED);
                     }
                 }
 
@@ -111,40 +356,72 @@ namespace sg
             // `is_connected` should either be equal to `sg::NOT_CONNECTED` or `sg::CONNECTED`
             void mod_connection(T a, T b, uint8_t is_connected)
             {
-                uint16_t a_index, b_index;
-
-                a_index = index_map.at(a);
-                b_index = index_map.at(b);
+                mod_connection_at(index_map.at(a), index_map.at(b), is_connected);
+            }
 
+            // same as `mod_connection`, but uses the indices of the data points in `data_list`
+            // skips the hashing, for when the caller already knows the indices
+            void mod_connection_at(uint32_t a_index, uint32_t b_index, uint8_t is_connected)
+            {
                 // set both possible orderings to be their connection since
-                // the adjacency matrix must be diagonally symmetric
-                adjacency_matrix->set(a_index, b_index, is_connected);
-                adjacency_matrix->set(b_index, a_index, is_connected);
+                // the connections must be symmetric
+                adjacency.set(a_index, b_index, is_connected);
+                adjacency.set(b_index, a_index, is_connected);
             }
 
 
             // returns whether or not `a` and `b` share a connection
             uint8_t is_connected(T a, T b) const
             {
-                // since the adjacency matrix is diagonally symmetric,
+                return is_connected_at(index_map.at(a), index_map.at(b));
+            }
+
+            // same as `is_connected`, but uses the indices of the data points in `data_list`
+            uint8_t is_connected_at(uint32_t a_index, uint32_t b_index) const
+            {
+                // since the connections are symmetric,
                 // the ordering of `a` and `b` is arbitrary,
                 // so I opted for `a` going first and `b` going second
-                return adjacency_matrix->get(index_map.at(a), index_map.at(b));
+                return adjacency.get(a_index, b_index);
+            }
+
+
+            // range over the indices (in `data_list`) of every data point connected to the data point at `index`
+            // doesn't allocate, so this is the fastest way to walk the graph
+            auto neighbors(uint32_t index) const
+            {
+                return adjacency.neighbors(index);
+            }
+
+            // range over every data point connected to the data point at `index`
+            // same as `neighbors`, but gives back the data points instead of their indices
+            auto connections_of(uint32_t index) const
+            {
+                return DataRange<T, decltype(adjacency.neighbors(index))>(data_list.data(), adjacency.neighbors(index));
+            }
+
+            // get the indices (in `data_list`) of every data point connected to the data point at `index`
+            std::vector<uint32_t> get_connection_indices_for(uint32_t index) const
+            {
+                std::vector<uint32_t> connections;
+
+                for (uint32_t i : adjacency.neighbors(index))
+                {
+                    connections.push_back(i);
+                }
+
+                return connections;
             }
 
-            
+
             // get a vector of connections for just a single data point
             std::vector<T> get_connections_for(T data) const
             {
                 std::vector<T> connections;
 
-                uint16_t index = index_map.at(data);
-                for (uint16_t i = 0; i < graph_size; ++i)
+                for (uint32_t i : adjacency.neighbors(index_map.at(data)))
                 {
-                    // if a connection is found, put it in the list of connections
-                    const uint8_t IS_CONNECTED = adjacency_matrix->get(index, i);
-                    if (IS_CONNECTED == CONNECTED)
-                        connections.push_back(data_list.at(i));
+                    connections.push_back(data_list.at(i));
                 }
 
                 return connections;
@@ -155,22 +432,12 @@ namespace sg
             std::unordered_map<T, std::vector<T>> get_connections() const
             {
                 std::unordered_map<T, std::vector<T>> rtrnval;
+                rtrnval.reserve(data_list.size());
 
                 for (auto x : data_list)
                 {
-                    std::vector<T> connections = get_connections_for(x);
-
-                    // uint16_t x_index = index_map.at(x);
-                    // for (uint16_t i = 0; i < graph_size; ++i)
-                    // {
-                    //     // if a connection is found, put the connection in the list of connections
-                    //     const uint8_t IS_CONNECTED = adjacency_matrix->get(x_index, i);
-                    //     if (IS_CONNECTED == CONNECTED)
-                    //         connections.push_back(data_list.at(i));
-                    // }
-
                     // add connections to map of all connections
-                    rtrnval.insert({x, connections});
+                    rtrnval.insert({x, get_connections_for(x)});
                 }
 
 
@@ -182,4 +449,4 @@ namespace sg
     };
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,110 @@
+/* Rosa Knowles
+ * 11/08/2025
+ * Definitions for the methods of `SpatialGrid`
+ */
+
+#include "spatialgrid.h"
+
+
+/* Constructor for the `SpatialGrid` class
+ * Splits the box from `origin` to `origin + extent` into square cells of side length `cell_size_arg`
+ */
+SpatialGrid::SpatialGrid(CoordinatePair origin, CoordinatePair extent, int32_t cell_size_arg,
+                         std::pmr::memory_resource * resource)
+    : rooms(resource), cell_heads(resource), nodes(resource)
+{
+    origin_x = origin.X;
+    origin_y = origin.Y;
+    cell_size = std::max(cell_size_arg, 1);
+
+    // round up, so the last partial cell still gets counted
+    columns = std::max((extent.X + cell_size - 1) / cell_size, 1);
+    rows    = std::max((extent.Y + cell_size - 1) / cell_size, 1);
+
+    // -1 marks an empty cell
+    cell_heads.assign((size_t)columns * rows, -1);
+}
+
+/* Private function
+ * Finds the first and last column and row that `room` touches
+ * Everything is clamped to the grid, so rooms outside of it end up in the edge cells
+ */
+void SpatialGrid::cell_range(const RoomPairs & room, int32_t & first_col, int32_t & last_col,
+                             int32_t & first_row, int32_t & last_row) const
+{
+    auto to_cell = [](int32_t coord, int32_t origin, int32_t size, int32_t count)
+    {
+        int32_t cell = (coord - origin) / size;
+        // integer division rounds towards 0, so negative coordinates need to be rounded down by hand
+        if (coord < origin)
+            cell = -1;
+
+        return std::min(std::max(cell, 0), count - 1);
+    };
+
+    first_col = to_cell(room.top_left.X, origin_x, cell_size, columns);
+    last_col  = to_cell(room.bottom_right.X, origin_x, cell_size, columns);
+    first_row = to_cell(room.top_left.Y, origin_y, cell_size, rows);
+    last_row  = to_cell(room.bottom_right.Y, origin_y, cell_size, rows);
+}
+
+/* Adds `room` to every cell that its bounding box touches
+ */
+void SpatialGrid::insert(const RoomPairs & room)
+{
+    const uint32_t INDEX = rooms.size();
+    rooms.push_back(room);
+
+    int32_t first_col, last_col, first_row, last_row;
+    cell_range(room, first_col, last_col, first_row, last_row);
+
+    for (int32_t r = first_row; r <= last_row; ++r)
+    {
+        for (int32_t c = first_col; c <= last_col; ++c)
+        {
+            int32_t & head = cell_heads[(size_t)r * columns + c];
+            nodes.push_back({INDEX, head});
+            head = nodes.size() - 1;
+        }
+    }
+}
+
+/* Returns the index of a room in the grid that overlaps with `room`, or -1 if there isn't one
+ * `check_overlap` only ever reports an overlap between boxes that touch,
+ * so only the rooms in the cells `room` touches need to be checked
+ */
+int32_t SpatialGrid::find_overlap(const RoomPairs & room) const
+{
+    int32_t first_col, last_col, first_row, last_row;
+    cell_range(room, first_col, last_col, first_row, last_row);
+
+    for (int32_t r = first_row; r <= last_row; ++r)
+    {
+        for (int32_t c = first_col; c <= last_col; ++c)
+        {
+            for (int32_t n = cell_heads[(size_t)r * columns + c]; n != -1; n = nodes[n].next)
+            {
+                // NOTE: a room that spans multiple cells can get checked more than once,
+                // but that's cheaper than keeping track of which rooms have been checked
+                if (check_overlap(rooms[nodes[n].room], room))
+                    return nodes[n].room;
+            }
+        }
+    }
+
+    return -1;
+}
+
+/* Returns whether `room` overlaps with any room in the grid
+ */
+bool SpatialGrid::overlaps_any(const RoomPairs & room) const
+{
+    return find_overlap(room) != -1;
+}
+
+// Getters
+// (self explanatory)
+const std::pmr::vector<RoomPairs> & SpatialGrid::get_rooms() const
+{
+    return rooms;
+}
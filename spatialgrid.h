@@ -0,0 +1,70 @@
+/* Rosa Knowles
+ * 11/08/2025
+ * Header file for `SpatialGrid`, a uniform grid of buckets used to find overlapping rooms quickly
+ * Each room is stored in every cell its bounding box touches, so an overlap check
+ * only has to look at the rooms in the cells the new room touches
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cstdint>
+#include <vector>
+#include <memory_resource>
+
+#include "dungeongen.h"
+
+
+class SpatialGrid
+{
+    private:
+        // world coordinates of the top-left corner of the grid
+        int32_t origin_x;
+        int32_t origin_y;
+        // side length of a single cell
+        int32_t cell_size;
+        // number of cells in each direction
+        int32_t columns;
+        int32_t rows;
+
+        // every room that has been inserted
+        std::pmr::vector<RoomPairs> rooms;
+
+        // each cell is a linked list of rooms
+        // `cell_heads` stores the first node of each cell, and each node points to the next one
+        struct Node
+        {
+            uint32_t room;
+            int32_t  next;
+        };
+        std::pmr::vector<int32_t> cell_heads;
+        std::pmr::vector<Node>    nodes;
+
+        // finds the range of cells that a room touches
+        // anything outside of the grid gets clamped to the cells on its edge
+        void cell_range(const RoomPairs & room, int32_t & first_col, int32_t & last_col,
+                        int32_t & first_row, int32_t & last_row) const;
+
+    public:
+        // constructor
+        // the grid covers the box from `origin` to `origin + extent`,
+        // but rooms outside of that box still work (they are just slower to check)
+        // everything the grid allocates comes from `resource`
+        SpatialGrid(CoordinatePair origin, CoordinatePair extent, int32_t cell_size_arg,
+                    std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+
+        // adds a room to the grid
+        void insert(const RoomPairs & room);
+
+        // returns the index of a room that overlaps with `room` (using `check_overlap`), or -1 if there isn't one
+        // stops at the first overlap it finds
+        int32_t find_overlap(const RoomPairs & room) const;
+
+        // returns whether `room` overlaps with any room in the grid
+        bool overlaps_any(const RoomPairs & room) const;
+
+        // getters
+        const std::pmr::vector<RoomPairs> & get_rooms() const;
+};
+
+#endif
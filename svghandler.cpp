@@ -10,19 +10,17 @@
 #include <fstream>
 
 
-/* Function that generates an svg graphic of a `SimpleGraph` object containing `CoordinatePair` structs
- * Takes `SimpleGraph<CoordinatePair> graph` as the graph that will be converted into an svg
+/* Function that generates an svg graphic of a `RoomGraph` object
+ * Takes `RoomGraph graph` as the graph that will be converted into an svg
  * `filepath` is the path to the svg file. must end with ".svg"
  * Returns nothing
  */
-void graph_to_svg(const sg::SimpleGraph<CoordinatePair> & graph, std::string filepath)
+void graph_to_svg(const RoomGraph & graph, std::string filepath)
 {
     using namespace std;
 
     // get list of vertices
-    vector<CoordinatePair> vertex_list = graph.get_data_list();
-    // get map of connections 
-    unordered_map<CoordinatePair, vector<CoordinatePair>> connections = graph.get_connections();
+    const pmr::vector<CoordinatePair> & vertex_list = graph.get_data_list();
 
     // find the width and height
     int32_t width, height;
@@ -51,19 +49,22 @@ void graph_to_svg(const sg::SimpleGraph<CoordinatePair> & graph, std::string fil
     svg_file << "<svg width=\"" << SVG_RESOLUTION * width << "\" height=\"" << SVG_RESOLUTION * height << "\" xmlns=\"http://www.w3.org/2000/svg\">\n";
 
     // add lines to svg file
-    for (const auto & vertex : vertex_list)
+    for (uint32_t i = 0; i < vertex_list.size(); ++i)
     {
+        const CoordinatePair & vertex = vertex_list[i];
+
         // iterate through each connection the vertex has
-        for (const auto & c : connections.at(vertex))
+        for (uint32_t j : graph.neighbors(i))
         {
+            // each line only needs to be drawn once, so skip the connections that were already drawn from the other end
+            if (j < i)
+                continue;
+
+            const CoordinatePair & c = vertex_list[j];
+
             svg_file << "\t<line x1=\"" << SVG_RESOLUTION * vertex.X << "\" y1=\"" << SVG_RESOLUTION * vertex.Y
                      << "\" x2=\"" << SVG_RESOLUTION * c.X << "\" y2=\"" << SVG_RESOLUTION * c.Y << "\" style=\"stroke:"
                      << SVG_CONNECTION_COLOR << ";stroke-width:" << SVG_RESOLUTION / 2 << "\" />\n";
-
-            // remove the connection from future iterations to prevent unnecessary repetition
-            auto pos = find(connections.at(c).begin(), connections.at(c).end(), vertex);
-            if (pos != connections.at(c).end())
-                connections.at(c).erase(pos);
         }
     }
 
@@ -0,0 +1,601 @@
+/* Rosa Knowles
+ * 11/24/2025
+ * Checks for the parts of the dungeon generator that have to be exactly right, like the geometric predicates
+ * Every check prints what it tested when it fails, and the program returns 1 if any of them did
+ *
+ * Usage: tests.exe
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <filesystem>
+
+#include "dungeongen.h"
+#include "triangulation.h"
+#include "chunkedworld.h"
+#include "tilekernels.h"
+#include "threadpool.h"
+#include "mapfile.h"
+#include "tilegrid.h"
+
+using namespace std;
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    int num_failures = 0;
+
+    // records a failure if `condition` is false
+    void check(bool condition, const string & what)
+    {
+        if (!condition)
+        {
+            cerr << "FAILED: " << what << endl;
+            num_failures++;
+        }
+    }
+
+    string point_str(const CoordinatePair & p)
+    {
+        return "(" + to_string(p.X) + ", " + to_string(p.Y) + ")";
+    }
+
+    /* For 4 counterclockwise points `a`, `b`, `c`, `d` on the same circle,
+     * the perturbed in-circle test has to agree with itself no matter which 3 points make the triangle
+     * The two ways of splitting the quad with a diagonal each test both triangles of the split against the 4th point,
+     * so in(a, b, c; d) == in(a, c, d; b), in(a, b, d; c) == in(b, c, d; a), and the two pairs have opposite signs
+     */
+    void check_cocircular_quad(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c, const CoordinatePair & d)
+    {
+        const string QUAD = point_str(a) + " " + point_str(b) + " " + point_str(c) + " " + point_str(d);
+
+        check(dt::orient2d(a, b, c) > 0 && dt::orient2d(a, c, d) > 0, "quad " + QUAD + " is counterclockwise");
+        check(dt::in_circle(a, b, c, d) == 0, "quad " + QUAD + " is cocircular");
+
+        const int ABC_D = dt::in_circle_perturbed(a, b, c, d);
+        const int ACD_B = dt::in_circle_perturbed(a, c, d, b);
+        const int ABD_C = dt::in_circle_perturbed(a, b, d, c);
+        const int BCD_A = dt::in_circle_perturbed(b, c, d, a);
+
+        check(ABC_D != 0 && ABD_C != 0, "in_circle_perturbed breaks the tie for quad " + QUAD);
+        check(ABC_D == ACD_B, "in(a, b, c; d) == in(a, c, d; b) for quad " + QUAD);
+        check(ABD_C == BCD_A, "in(a, b, d; c) == in(b, c, d; a) for quad " + QUAD);
+        check(ABC_D == -ABD_C, "the two diagonals of quad " + QUAD + " disagree");
+    }
+
+    void test_in_circle_perturbed()
+    {
+        // every starting corner of each quad, since the tie break depends on the order of the coordinates
+        const vector<vector<CoordinatePair>> QUADS =
+        {
+            {{0, 0}, {4, 0}, {4, 4}, {0, 4}},
+            {{5, 0}, {3, 4}, {-3, 4}, {-4, -3}},
+            {{0, -5}, {4, 3}, {0, 5}, {-3, -4}},
+            {{1, 1}, {7, 1}, {7, 3}, {1, 3}}
+        };
+
+        for (const auto & quad : QUADS)
+        {
+            for (int start = 0; start < 4; ++start)
+            {
+                check_cocircular_quad(quad[start], quad[(start + 1) % 4], quad[(start + 2) % 4], quad[(start + 3) % 4]);
+            }
+        }
+    }
+
+    // edges of the triangulation of `points`, as sorted pairs of points (so they don't depend on the order of `points`)
+    vector<pair<pair<int32_t, int32_t>, pair<int32_t, int32_t>>> triangulation_edges(const vector<CoordinatePair> & points)
+    {
+        dt::Triangulation triangulation;
+        triangulation.triangulate(points);
+
+        vector<pair<pair<int32_t, int32_t>, pair<int32_t, int32_t>>> rtrnval;
+        for (const auto & [i, j] : triangulation.get_edges())
+        {
+            pair<int32_t, int32_t> p = {points[i].X, points[i].Y};
+            pair<int32_t, int32_t> q = {points[j].X, points[j].Y};
+            rtrnval.push_back(minmax(p, q));
+        }
+        sort(rtrnval.begin(), rtrnval.end());
+
+        return rtrnval;
+    }
+
+    /* Triangulates `points`, and then `points` shuffled over and over, and checks that it always comes out the same
+     */
+    void check_shuffled(vector<CoordinatePair> points, const string & name)
+    {
+        const auto EXPECTED = triangulation_edges(points);
+
+        mt19937 rng(1);
+        for (int trial = 0; trial < 20; ++trial)
+        {
+            shuffle(points.begin(), points.end(), rng);
+            check(triangulation_edges(points) == EXPECTED, "shuffled " + name + " " + to_string(trial) + " triangulates the same way");
+        }
+    }
+
+    /* A grid is full of cocircular points (every square of 4 neighbors),
+     * so shuffling the points shouldn't change which diagonal each square gets
+     * Same for the 28 integer points on a circle of radius 25, which all share one circumcircle
+     */
+    void test_shuffled_cocircular()
+    {
+        vector<CoordinatePair> grid;
+        for (int32_t y = 0; y < 8; ++y)
+        {
+            for (int32_t x = 0; x < 8; ++x)
+            {
+                grid.push_back({x * 10 + 5, y * 10 + 5});
+            }
+        }
+
+        // an 8 x 8 grid has 7 * 8 horizontal, 7 * 8 vertical, and 7 * 7 diagonal edges
+        const size_t NUM_GRID_EDGES = triangulation_edges(grid).size();
+        check(NUM_GRID_EDGES == 7 * 8 * 2 + 7 * 7, "8 x 8 grid has " + to_string(NUM_GRID_EDGES) + " edges instead of 161");
+        check_shuffled(grid, "grid");
+
+        vector<CoordinatePair> circle;
+        for (const auto & [x, y] : vector<pair<int32_t, int32_t>>{{0, 25}, {7, 24}, {15, 20}, {20, 15}, {24, 7}, {25, 0}})
+        {
+            for (const auto & [sx, sy] : vector<pair<int32_t, int32_t>>{{1, 1}, {1, -1}, {-1, 1}, {-1, -1}})
+            {
+                const CoordinatePair P = {100 + sx * x, 100 + sy * y};
+                if (find(circle.begin(), circle.end(), P) == circle.end())
+                    circle.push_back(P);
+            }
+        }
+
+        // a convex polygon with n corners always has n - 3 diagonals, so 2n - 3 edges
+        const size_t NUM_CIRCLE_EDGES = triangulation_edges(circle).size();
+        check(NUM_CIRCLE_EDGES == 2 * circle.size() - 3, "circle of " + to_string(circle.size()) + " points has "
+              + to_string(NUM_CIRCLE_EDGES) + " edges instead of " + to_string(2 * circle.size() - 3));
+        check_shuffled(circle, "circle");
+    }
+
+    /* Dense and sparse graphs with the same connections have to list the same neighbors, in the same (increasing) order
+     * Includes the first and last data points, since the dense neighbor scan stops at the end of a row
+     */
+    void test_graph_storage()
+    {
+        vector<int> data;
+        for (int i = 0; i < 40; ++i)
+        {
+            data.push_back(i);
+        }
+
+        sg::SimpleGraph<int, sg::DenseAdjacency> dense(data);
+        sg::SimpleGraph<int, sg::SparseAdjacency> sparse(data);
+
+        mt19937 rng(2);
+        for (int i = 0; i < 200; ++i)
+        {
+            const uint32_t A = rng() % data.size();
+            const uint32_t B = rng() % data.size();
+            const uint8_t VALUE = (rng() % 4 == 0) ? sg::NOT_CONNECTED : sg::CONNECTED;
+            dense.mod_connection_at(A, B, VALUE);
+            sparse.mod_connection_at(A, B, VALUE);
+        }
+        dense.mod_connection_at(0, data.size() - 1, sg::CONNECTED);
+        sparse.mod_connection_at(0, data.size() - 1, sg::CONNECTED);
+
+        for (uint32_t i = 0; i < data.size(); ++i)
+        {
+            vector<uint32_t> dense_neighbors;
+            for (uint32_t j : dense.neighbors(i))
+            {
+                dense_neighbors.push_back(j);
+            }
+            vector<uint32_t> sparse_neighbors;
+            for (uint32_t j : sparse.neighbors(i))
+            {
+                sparse_neighbors.push_back(j);
+            }
+
+            check(dense_neighbors == sparse_neighbors, "dense and sparse graphs have the same neighbors for " + to_string(i));
+            for (uint32_t j : dense_neighbors)
+            {
+                check(dense.is_connected_at(i, j) == sg::CONNECTED && dense.is_connected_at(j, i) == sg::CONNECTED,
+                      "dense graph connection " + to_string(i) + " - " + to_string(j) + " goes both ways");
+            }
+        }
+        check(dense.count_connections() == sparse.count_connections(), "dense and sparse graphs have the same number of connections");
+    }
+
+    /* A map whose rooms would be spread over more than 2^32 tiles has to be rejected with its real size,
+     * instead of wrapping around to a smaller size and getting built wrong
+     */
+    void test_map_too_big()
+    {
+        string message;
+        try
+        {
+            DungeonMap map(60000, 65000, 200000);
+            map.generate(1);
+        }
+        catch (const length_error & e)
+        {
+            message = e.what();
+        }
+
+        // 65000 * 200000 / 3 + 65000 + 1 + 2 * PADDING
+        check(message.find("4333398344 x 4333398344") != string::npos, "huge map throws a length_error with its real size, got \"" + message + "\"");
+    }
+
+    /* `dilate_walls` has to count exactly the walls it places, with and without a thread pool
+     * The width isn't a multiple of 16 or 32, so the SIMD loops and the leftover tiles at the end of a row both get counted
+     */
+    void test_dilate_walls_count()
+    {
+        const size_t WIDTH = 77;
+        const size_t HEIGHT = 50;
+
+        vector<uint8_t> tiles(WIDTH * HEIGHT);
+        mt19937 rng(3);
+        for (auto & tile : tiles)
+        {
+            const uint32_t ROLL = rng() % 16;
+            tile = (ROLL == 0) ? TILES::FLOOR : ((ROLL == 1) ? TILES::WALL : TILES::EMPTY);
+        }
+
+        auto count_walls = [](const vector<uint8_t> & grid) { return (size_t)count(grid.begin(), grid.end(), TILES::WALL); };
+
+        vector<uint8_t> serial = tiles;
+        const size_t SERIAL_WALLS = tk::dilate_walls(serial.data(), WIDTH, HEIGHT);
+        check(SERIAL_WALLS == count_walls(serial) - count_walls(tiles), "dilate_walls counts the walls it places");
+
+        ThreadPool pool(3);
+        vector<uint8_t> banded = tiles;
+        const size_t BANDED_WALLS = tk::dilate_walls(banded.data(), WIDTH, HEIGHT, pool, 5);
+        check(banded == serial, "banded dilate_walls places the same walls");
+        check(BANDED_WALLS == SERIAL_WALLS, "banded dilate_walls counts the same walls");
+    }
+
+    // a path in the temp directory for the map files the tests write
+    string temp_map_path(const string & name)
+    {
+        return (filesystem::temp_directory_path() / ("dungeongen_tests_" + name + ".dmap")).string();
+    }
+
+    vector<uint8_t> read_bytes(const string & path)
+    {
+        ifstream file(path, ios::binary);
+        return vector<uint8_t>(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    }
+
+    void write_bytes(const string & path, const vector<uint8_t> & bytes)
+    {
+        ofstream file(path, ios::binary | ios::trunc);
+        file.write((const char *)bytes.data(), bytes.size());
+    }
+
+    // returns whether opening the map file at `path` throws an `std::runtime_error`
+    bool map_file_rejected(const string & path)
+    {
+        try
+        {
+            MapFile file(path);
+        }
+        catch (const runtime_error &)
+        {
+            return true;
+        }
+        return false;
+    }
+
+    /* Saves `map` with and without run length encoding, and checks that loading it gives back the same map
+     */
+    void check_map_file_round_trip(const DungeonMap & map, bool compress_tiles)
+    {
+        const string NAME = compress_tiles ? "rle" : "raw";
+        const string PATH = temp_map_path(NAME);
+        save_map_file(map, PATH, compress_tiles);
+
+        const MapFile FILE(PATH);
+        const ByteMatrix2D & matrix = *map.get_matrix();
+
+        check(FILE.is_compressed() == compress_tiles, NAME + " map file has the right flags");
+        check(FILE.get_seed() == map.get_seed(), NAME + " map file has the same seed");
+        check(FILE.get_width() == matrix.get_width() && FILE.get_height() == matrix.get_height(), NAME + " map file has the same size");
+        check((FILE.get_tiles() != nullptr) == !compress_tiles, NAME + " map file only has raw tiles if it isn't compressed");
+
+        vector<uint8_t> row(FILE.get_width());
+        bool same_tiles = true;
+        for (uint32_t y = 0; y < FILE.get_height(); ++y)
+        {
+            FILE.decode_row(y, row.data());
+            same_tiles = same_tiles && memcmp(row.data(), matrix.row(y), row.size()) == 0;
+            // `get_tile` walks the runs on its own, so check it on the last tile of every row
+            same_tiles = same_tiles && FILE.get_tile(FILE.get_width() - 1, y) == matrix.row(y)[FILE.get_width() - 1];
+        }
+        check(same_tiles, NAME + " map file has the same tiles");
+
+        const vector<RoomPairs> & rooms = map.get_rooms();
+        check(FILE.get_num_rooms() == rooms.size()
+              && memcmp(FILE.get_rooms(), rooms.data(), rooms.size() * sizeof(RoomPairs)) == 0, NAME + " map file has the same rooms");
+        const vector<HallEdge> & hall_edges = map.get_hall_edges();
+        check(FILE.get_num_hall_edges() == hall_edges.size()
+              && memcmp(FILE.get_hall_edges(), hall_edges.data(), hall_edges.size() * sizeof(HallEdge)) == 0,
+              NAME + " map file has the same hallways");
+    }
+
+    /* Map files have to load back exactly as they were saved, and broken ones have to be caught
+     * instead of being read out of bounds
+     */
+    void test_map_file()
+    {
+        DungeonMap map(6, 10, 15);
+        map.generate(4);
+
+        check_map_file_round_trip(map, false);
+        check_map_file_round_trip(map, true);
+
+        const string PATH = temp_map_path("rle");
+        const string BROKEN_PATH = temp_map_path("broken");
+        const vector<uint8_t> BYTES = read_bytes(PATH);
+        mf::Header header;
+        memcpy(&header, BYTES.data(), sizeof(header));
+
+        // cut off in the middle of the header, and in the middle of the tiles
+        write_bytes(BROKEN_PATH, vector<uint8_t>(BYTES.begin(), BYTES.begin() + sizeof(mf::Header) / 2));
+        check(map_file_rejected(BROKEN_PATH), "map file cut off in its header is rejected");
+        write_bytes(BROKEN_PATH, vector<uint8_t>(BYTES.begin(), BYTES.begin() + header.tiles_offset + header.tiles_size / 2));
+        check(map_file_rejected(BROKEN_PATH), "map file cut off in its tiles is rejected");
+
+        // row offsets that go backwards, and one that's in the middle of a run
+        uint32_t row_offsets[2];
+        const size_t ROW_1 = header.tiles_offset + sizeof(uint32_t);
+        memcpy(row_offsets, BYTES.data() + ROW_1, sizeof(row_offsets));
+
+        vector<uint8_t> broken = BYTES;
+        const uint32_t BACKWARDS = row_offsets[1] + 2;
+        memcpy(broken.data() + ROW_1, &BACKWARDS, sizeof(BACKWARDS));
+        write_bytes(BROKEN_PATH, broken);
+        check(map_file_rejected(BROKEN_PATH), "map file whose row table goes backwards is rejected");
+
+        broken = BYTES;
+        const uint32_t ODD = row_offsets[0] + 1;
+        memcpy(broken.data() + ROW_1, &ODD, sizeof(ODD));
+        write_bytes(BROKEN_PATH, broken);
+        check(map_file_rejected(BROKEN_PATH), "map file whose row table splits a run is rejected");
+
+        // one tile moved from the first run of a row to the last run of the row above it,
+        // so the map has the right number of tiles, but a run crosses from one row into the next
+        // the row table is still fine, so this only gets caught when the row is decoded
+        broken = BYTES;
+        vector<uint32_t> all_offsets(header.height + 1);
+        memcpy(all_offsets.data(), BYTES.data() + header.tiles_offset, all_offsets.size() * sizeof(uint32_t));
+        uint8_t * runs = broken.data() + header.tiles_offset + all_offsets.size() * sizeof(uint32_t);
+
+        uint32_t crossing_row = 0;
+        while (crossing_row + 1 < header.height
+               && (runs[all_offsets[crossing_row + 1] - 1] == 0xFF || runs[all_offsets[crossing_row + 1] + 1] == 0))
+        {
+            crossing_row++;
+        }
+        check(crossing_row + 1 < header.height, "map has a row whose last run can be made longer");
+        runs[all_offsets[crossing_row + 1] - 1]++;
+        runs[all_offsets[crossing_row + 1] + 1]--;
+        write_bytes(BROKEN_PATH, broken);
+
+        bool crossing_rejected = false;
+        try
+        {
+            const MapFile FILE(BROKEN_PATH);
+            vector<uint8_t> row(FILE.get_width());
+            FILE.decode_row(crossing_row, row.data());
+        }
+        catch (const runtime_error &)
+        {
+            crossing_rejected = true;
+        }
+        check(crossing_rejected, "map file with a run that crosses into the next row is rejected");
+
+        filesystem::remove(PATH);
+        filesystem::remove(temp_map_path("raw"));
+        filesystem::remove(BROKEN_PATH);
+    }
+
+    /* Compacting a map in any of the storages has to keep every tile the same
+     */
+    void test_compact()
+    {
+        const vector<pair<TileStorage, string>> STORAGES =
+        {
+            {TileStorage::BYTES, "BYTES"},
+            {TileStorage::PACKED_4BIT, "PACKED_4BIT"},
+            {TileStorage::ROW_RLE, "ROW_RLE"}
+        };
+
+        for (int32_t seed : {1, 7})
+        {
+            DungeonMap map(6, 10, 40);
+            map.generate(seed);
+            const string EXPECTED = map.as_str();
+
+            for (const auto & [storage, name] : STORAGES)
+            {
+                DungeonMap compacted(6, 10, 40);
+                compacted.generate(seed);
+                compacted.compact(storage);
+
+                check(compacted.get_matrix() == nullptr && compacted.get_tile_grid() != nullptr, name + " compact frees the matrix");
+                check(compacted.as_str() == EXPECTED, name + " compacted map with seed " + to_string(seed) + " prints the same");
+            }
+        }
+    }
+
+    /* Returns whether every room of `chunk` can be reached from the door on its left border, walking only on floor
+     */
+    bool chunk_rooms_reachable(const WorldChunk & chunk, uint16_t chunk_size)
+    {
+        const ByteMatrix2D & tiles = chunk.tiles;
+
+        vector<uint8_t> seen((size_t)chunk_size * chunk_size, 0);
+        vector<pair<int32_t, int32_t>> stack;
+        for (int32_t y = 0; y < chunk_size; ++y)
+        {
+            if (tiles(0, y) == TILES::FLOOR)
+            {
+                stack.push_back({0, y});
+                seen[(size_t)y * chunk_size] = 1;
+            }
+        }
+
+        while (!stack.empty())
+        {
+            const auto [X, Y] = stack.back();
+            stack.pop_back();
+
+            const int32_t STEPS[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+            for (const auto & step : STEPS)
+            {
+                const int32_t NX = X + step[0];
+                const int32_t NY = Y + step[1];
+                if (NX < 0 || NY < 0 || NX >= chunk_size || NY >= chunk_size)
+                    continue;
+                if (seen[(size_t)NY * chunk_size + NX] || tiles(NX, NY) != TILES::FLOOR)
+                    continue;
+
+                seen[(size_t)NY * chunk_size + NX] = 1;
+                stack.push_back({NX, NY});
+            }
+        }
+
+        for (const auto & rp : chunk.rooms)
+        {
+            const int64_t X = rp.center.X - (int64_t)chunk.cx * chunk_size;
+            const int64_t Y = rp.center.Y - (int64_t)chunk.cy * chunk_size;
+            if (!seen[(size_t)Y * chunk_size + X])
+                return false;
+        }
+        return true;
+    }
+
+    /* Returns the positions along the border of `chunk` that are floor
+     * `side` is 0 for the left border, 1 for the top, 2 for the right, and 3 for the bottom
+     */
+    vector<uint16_t> border_floors(const WorldChunk & chunk, uint16_t chunk_size, int side)
+    {
+        vector<uint16_t> rtrnval;
+        const uint16_t LAST = chunk_size - 1;
+        for (uint16_t i = 0; i < chunk_size; ++i)
+        {
+            const uint8_t TILE = (side == 0) ? chunk.tiles(0, i)
+                               : (side == 1) ? chunk.tiles(i, 0)
+                               : (side == 2) ? chunk.tiles(LAST, i)
+                                             : chunk.tiles(i, LAST);
+            if (TILE == TILES::FLOOR)
+                rtrnval.push_back(i);
+        }
+        return rtrnval;
+    }
+
+    /* Neighboring chunks are generated on their own, but have to agree on where the door between them is,
+     * so both sides of every border have floor on the same 2 tiles, and nowhere else
+     */
+    void test_chunk_borders()
+    {
+        ChunkedWorld world(5, 96, 6, 10, 8);
+        const uint16_t SIZE = world.get_chunk_size();
+
+        for (int32_t cy = -2; cy <= 1; ++cy)
+        {
+            for (int32_t cx = -2; cx <= 1; ++cx)
+            {
+                const auto CHUNK = world.get_chunk(cx, cy);
+                const auto RIGHT = world.get_chunk(cx + 1, cy);
+                const auto BELOW = world.get_chunk(cx, cy + 1);
+                const string NAME = "chunk (" + to_string(cx) + ", " + to_string(cy) + ")";
+
+                const vector<uint16_t> RIGHT_DOOR = border_floors(*CHUNK, SIZE, 2);
+                check(RIGHT_DOOR.size() == 2 && RIGHT_DOOR[1] == RIGHT_DOOR[0] + 1, NAME + " has a 2 tile door on its right border");
+                check(RIGHT_DOOR == border_floors(*RIGHT, SIZE, 0), NAME + " and the chunk to its right have the same door");
+
+                const vector<uint16_t> BOTTOM_DOOR = border_floors(*CHUNK, SIZE, 3);
+                check(BOTTOM_DOOR.size() == 2 && BOTTOM_DOOR[1] == BOTTOM_DOOR[0] + 1, NAME + " has a 2 tile door on its bottom border");
+                check(BOTTOM_DOOR == border_floors(*BELOW, SIZE, 1), NAME + " and the chunk below it have the same door");
+            }
+        }
+    }
+
+    /* A chunk that got evicted has to come back exactly the same when it's generated again
+     */
+    void test_chunk_regeneration()
+    {
+        // a budget of 1 byte only ever keeps the most recent chunk
+        ChunkedWorld world(9, 96, 6, 10, 8, 1);
+        const auto FIRST = world.get_chunk(3, -4);
+
+        for (int32_t cx = 0; cx < 3; ++cx)
+        {
+            world.get_chunk(cx, 0);
+        }
+        check(!world.is_loaded(3, -4) && world.get_chunks_evicted() >= 3, "chunks past the memory budget get evicted");
+
+        const auto AGAIN = world.get_chunk(3, -4);
+        check(AGAIN != FIRST, "evicted chunk gets generated again");
+        check(AGAIN->seed == FIRST->seed, "regenerated chunk has the same seed");
+        check(AGAIN->tiles.as_str() == FIRST->tiles.as_str(), "regenerated chunk has the same tiles");
+        check(AGAIN->rooms.size() == FIRST->rooms.size()
+              && equal(AGAIN->rooms.begin(), AGAIN->rooms.end(), FIRST->rooms.begin(),
+                       [](const RoomPairs & a, const RoomPairs & b) { return memcmp(&a, &b, sizeof(RoomPairs)) == 0; }),
+              "regenerated chunk has the same rooms");
+        check(AGAIN->hall_edges.size() == FIRST->hall_edges.size()
+              && equal(AGAIN->hall_edges.begin(), AGAIN->hall_edges.end(), FIRST->hall_edges.begin(),
+                       [](const HallEdge & a, const HallEdge & b) { return a.a == b.a && a.b == b.b; }),
+              "regenerated chunk has the same hallways");
+    }
+
+    /* Chunks with too few rooms to triangulate still have to connect every room to the doors
+     */
+    void test_chunk_connectivity()
+    {
+        for (uint32_t rooms_per_chunk : {1u, 2u, 3u, 8u})
+        {
+            ChunkedWorld world(3, 96, 6, 10, rooms_per_chunk);
+
+            for (int32_t cx = -2; cx <= 2; ++cx)
+            {
+                auto chunk = world.get_chunk(cx, 0);
+                const string NAME = "chunk (" + to_string(cx) + ", 0) with " + to_string(rooms_per_chunk) + " rooms";
+
+                check(chunk->hall_edges.size() + 1 >= chunk->rooms.size(), NAME + " has enough hallways to connect its rooms");
+                check(chunk_rooms_reachable(*chunk, world.get_chunk_size()), NAME + " can reach every room from its door");
+            }
+        }
+    }
+};
+
+
+int main()
+{
+    test_in_circle_perturbed();
+    test_shuffled_cocircular();
+    test_graph_storage();
+    test_map_too_big();
+    test_dilate_walls_count();
+    test_map_file();
+    test_compact();
+    test_chunk_connectivity();
+    test_chunk_borders();
+    test_chunk_regeneration();
+
+    if (num_failures > 0)
+    {
+        cerr << num_failures << " check(s) failed" << endl;
+        return 1;
+    }
+
+    cout << "All checks passed" << endl;
+    return 0;
+}
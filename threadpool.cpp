@@ -0,0 +1,238 @@
+/* Rosa Knowles
+ * 11/03/2025
+ * Definitions for the methods of `ThreadPool`
+ */
+
+#include "threadpool.h"
+
+#include <exception>
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // index used for threads that aren't workers of the pool
+    const size_t NOT_A_WORKER = SIZE_MAX;
+
+    // lets a task know which pool (and which deque in that pool) it is running on
+    thread_local const ThreadPool * current_pool = nullptr;
+    thread_local size_t current_index = NOT_A_WORKER;
+};
+
+
+/* Constructor for the `ThreadPool` class
+ * Spawns `num_threads` workers, each with their own deque
+ * `num_threads` == 0 uses `std::thread::hardware_concurrency`
+ */
+ThreadPool::ThreadPool(unsigned num_threads)
+{
+    if (num_threads == 0)
+        num_threads = std::thread::hardware_concurrency();
+    // `hardware_concurrency` is allowed to return 0 if it can't tell
+    if (num_threads == 0)
+        num_threads = 1;
+
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // the queues have to exist before any of the workers start stealing from them
+    for (unsigned i = 0; i < num_threads; ++i)
+    {
+        workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+/* Destructor for the `ThreadPool` class
+ * Lets the workers drain their queues before joining them
+ */
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    work_available.notify_all();
+
+    for (auto & w : workers)
+    {
+        w.join();
+    }
+}
+
+/* Private function
+ * Pops a task from the back of the worker's own deque
+ * If that deque is empty, steals a task from the front of another worker's deque
+ * Returns whether or not a task was found
+ */
+bool ThreadPool::try_pop(size_t self, std::function<void()> & task)
+{
+    const size_t NUM_QUEUES = queues.size();
+
+    if (self < NUM_QUEUES)
+    {
+        WorkerQueue & own = *queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.tasks.empty())
+        {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued_tasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    // start stealing from the worker after this one, so every thread doesn't pile onto queue 0
+    const size_t START = (self < NUM_QUEUES) ? self + 1 : 0;
+    for (size_t i = 0; i < NUM_QUEUES; ++i)
+    {
+        const size_t VICTIM = (START + i) % NUM_QUEUES;
+        if (VICTIM == self)
+            continue;
+
+        WorkerQueue & other = *queues[VICTIM];
+        std::lock_guard<std::mutex> guard(other.lock);
+        if (!other.tasks.empty())
+        {
+            task = std::move(other.tasks.front());
+            other.tasks.pop_front();
+            queued_tasks.fetch_sub(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Private function
+ * Main loop for each worker thread
+ * Runs tasks until the pool is stopping and every queue is empty
+ */
+void ThreadPool::worker_loop(size_t self)
+{
+    current_pool = this;
+    current_index = self;
+
+    while (true)
+    {
+        std::function<void()> task;
+        if (try_pop(self, task))
+        {
+            task();
+            continue;
+        }
+
+        // nothing to run, so sleep until something is submitted
+        std::unique_lock<std::mutex> guard(sleep_lock);
+        work_available.wait(guard, [this] { return stopping || queued_tasks.load() > 0; });
+
+        if (stopping && queued_tasks.load() == 0)
+            return;
+    }
+}
+
+/* Queues a task on the pool
+ * Tasks submitted from one of this pool's workers are pushed onto that worker's deque,
+ * everything else is spread across the deques round robin
+ */
+void ThreadPool::submit(std::function<void()> task)
+{
+    const size_t TARGET = (current_pool == this) ?
+        current_index :
+        next_queue.fetch_add(1) % queues.size();
+
+    {
+        WorkerQueue & q = *queues[TARGET];
+        std::lock_guard<std::mutex> guard(q.lock);
+        q.tasks.push_back(std::move(task));
+    }
+
+    // the count is bumped under `sleep_lock` so a worker can't miss the wakeup
+    {
+        std::lock_guard<std::mutex> guard(sleep_lock);
+        queued_tasks.fetch_add(1);
+    }
+    work_available.notify_one();
+}
+
+/* Calls `fn(i)` for each `i` in [0, count), spread across the pool
+ * The calling thread runs queued tasks until all of its calls have been picked up,
+ * and then sleeps until the last one finishes, so it doesn't take a core away from the workers
+ * If any call throws, the first exception is rethrown here once everything is done
+ */
+void ThreadPool::parallel_for(size_t count, const std::function<void(size_t)> & fn)
+{
+    if (count == 0)
+        return;
+
+    // not worth the overhead of queueing anything
+    if (count == 1)
+    {
+        fn(0);
+        return;
+    }
+
+    std::atomic<size_t> remaining(count);
+    std::exception_ptr first_error = nullptr;
+    std::mutex error_lock;
+    // the last call to finish wakes the calling thread up with this
+    std::mutex done_lock;
+    std::condition_variable all_done;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        submit([&, i]
+        {
+            try
+            {
+                fn(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> guard(error_lock);
+                if (first_error == nullptr)
+                    first_error = std::current_exception();
+            }
+
+            // counted down under `done_lock`, so the calling thread can't see 0, return,
+            // and destroy `done_lock` and `all_done` while they are still being used here
+            std::lock_guard<std::mutex> guard(done_lock);
+            if (remaining.fetch_sub(1, std::memory_order_release) == 1)
+                all_done.notify_all();
+        });
+    }
+
+    // help out instead of blocking
+    // this is what makes nested calls from inside a task safe
+    const size_t SELF = (current_pool == this) ? current_index : NOT_A_WORKER;
+    while (remaining.load(std::memory_order_acquire) > 0)
+    {
+        std::function<void()> task;
+        if (try_pop(SELF, task))
+        {
+            task();
+            continue;
+        }
+
+        // every queue was empty, so all of the calls have been picked up and are running on other threads
+        // none of them can go back on a queue, so there is nothing left to help with until they finish
+        std::unique_lock<std::mutex> guard(done_lock);
+        all_done.wait(guard, [&] { return remaining.load(std::memory_order_acquire) == 0; });
+    }
+
+    // the last call might still be holding `done_lock`, so wait for it to let go before `done_lock` goes away
+    {
+        std::lock_guard<std::mutex> guard(done_lock);
+    }
+
+    if (first_error != nullptr)
+        std::rethrow_exception(first_error);
+}
+
+// Getters
+// (self explanatory)
+unsigned ThreadPool::size() const
+{
+    return workers.size();
+}
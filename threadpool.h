@@ -0,0 +1,72 @@
+/* Rosa Knowles
+ * 11/03/2025
+ * Header file for `ThreadPool`, a small work-stealing thread pool
+ * Each worker owns a deque of tasks. Workers pop from the back of their own deque,
+ * and steal from the front of the other deques when they run out of work
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+class ThreadPool
+{
+    private:
+        // a single worker's queue of tasks
+        // guarded by its own lock, so stealing only contends with one other thread
+        struct WorkerQueue
+        {
+            std::mutex lock;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+
+        // used to put idle workers to sleep
+        std::mutex              sleep_lock;
+        std::condition_variable work_available;
+
+        // number of tasks that have been submitted but not yet picked up
+        std::atomic<size_t> queued_tasks{0};
+        // round robin counter for tasks submitted from outside the pool
+        std::atomic<size_t> next_queue{0};
+        bool stopping = false;
+
+        void worker_loop(size_t self);
+        bool try_pop(size_t self, std::function<void()> & task);
+
+    public:
+        // constructor
+        // `num_threads` == 0 uses the number of hardware threads
+        explicit ThreadPool(unsigned num_threads = 0);
+        // destructor
+        // finishes all queued tasks, then joins the workers
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool & operator=(const ThreadPool &) = delete;
+
+        // queues a task
+        // tasks submitted from a worker go on that worker's own deque
+        void submit(std::function<void()> task);
+
+        // calls `fn(i)` for every `i` in [0, count), and blocks until every call has returned
+        // the calling thread helps with the work while it waits, so this is safe to call from inside a task
+        void parallel_for(size_t count, const std::function<void(size_t)> & fn);
+
+        // getters
+        unsigned size() const;
+};
+
+#endif
@@ -0,0 +1,362 @@
+/* Rosa Knowles
+ * 11/21/2025
+ * Definitions for the methods of `TileGrid` and the different kinds of tile grids
+ */
+
+#include "tilegrid.h"
+
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+
+// every tile in `TILES`, in the order of their 4-bit codes
+const uint8_t PackedTileGrid::CODES[5] =
+{
+    TILES::EMPTY,
+    TILES::WALL,
+    TILES::FLOOR,
+    TILES::PLAYER_SPAWN,
+    TILES::TREASURE
+};
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // code used in `ENCODE` for bytes that aren't a tile
+    const uint8_t NOT_A_TILE = 0xFF;
+
+    /* Lookup tables for `PackedTileGrid`
+     * `encode` turns a tile into its 4-bit code, and `decode` turns a packed byte straight into both of its tiles
+     */
+    struct PackingTables
+    {
+        uint8_t encode[256];
+        uint8_t decode[256][2];
+
+        PackingTables()
+        {
+            const size_t NUM_CODES = sizeof(PackedTileGrid::CODES);
+
+            memset(encode, NOT_A_TILE, sizeof(encode));
+            for (size_t code = 0; code < NUM_CODES; ++code)
+            {
+                encode[PackedTileGrid::CODES[code]] = code;
+            }
+
+            // codes that don't stand for a tile never get written, so they just decode to empty space
+            for (size_t b = 0; b < 256; ++b)
+            {
+                const size_t LOW = b & 0x0F;
+                const size_t HIGH = b >> 4;
+                decode[b][0] = (LOW < NUM_CODES) ? PackedTileGrid::CODES[LOW] : TILES::EMPTY;
+                decode[b][1] = (HIGH < NUM_CODES) ? PackedTileGrid::CODES[HIGH] : TILES::EMPTY;
+            }
+        }
+    };
+
+    const PackingTables & packing_tables()
+    {
+        static const PackingTables TABLES;
+        return TABLES;
+    }
+};
+
+
+/* Protected function
+ * Throws an `std::out_of_range` if (`x`, `y`) is outside of the grid
+ */
+void TileGrid::check_bounds(matrix_dim_t x, matrix_dim_t y) const
+{
+    using namespace std;
+
+    if (x >= width || y >= height)
+    {
+        throw out_of_range("Coordinate (" + to_string(x) + ", " + to_string(y)
+            + ") out of range for TileGrid of size "
+            + to_string(width) + " x " + to_string(height));
+    }
+}
+
+/* Converts the grid to a string using the tiles
+ * Each row is decoded straight into the string, which is sized once up front
+ */
+std::string TileGrid::as_str() const
+{
+    using namespace std;
+
+    if (width == 0 || height == 0)
+        return "";
+
+    // every row, plus a newline between each of them
+    string rtrnval;
+    rtrnval.resize(((size_t)width + 1) * height - 1);
+
+    char * out = &rtrnval[0];
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        decode_row(y, (uint8_t *)out);
+        out += width;
+
+        // adds a newline at the end of every row but the last one
+        if (y + 1 < height)
+            *out++ = '\n';
+    }
+
+    return rtrnval;
+}
+
+/* Writes the same text as `as_str` to `os`
+ * Only one row is decoded at a time
+ */
+void TileGrid::write_to(std::ostream & os) const
+{
+    std::vector<uint8_t> row(width);
+
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        decode_row(y, row.data());
+        os.write((const char *)row.data(), width);
+
+        if (y + 1 < height)
+            os.put('\n');
+    }
+}
+
+/* Decodes the whole grid back into a matrix, one byte per tile
+ */
+ByteMatrix2D TileGrid::to_matrix() const
+{
+    ByteMatrix2D rtrnval(width, height);
+
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        decode_row(y, rtrnval.row(y));
+    }
+
+    return rtrnval;
+}
+
+
+/* Constructor for the `ByteTileGrid` class
+ * Just copies the matrix
+ */
+ByteTileGrid::ByteTileGrid(const ByteMatrix2D & matrix) : tiles(matrix)
+{
+    width = matrix.get_width();
+    height = matrix.get_height();
+}
+
+uint8_t ByteTileGrid::get_tile(matrix_dim_t x, matrix_dim_t y) const
+{
+    check_bounds(x, y);
+    return tiles(x, y);
+}
+
+void ByteTileGrid::decode_row(matrix_dim_t y, uint8_t * out) const
+{
+    check_bounds(0, y);
+    memcpy(out, tiles.row(y), width);
+}
+
+size_t ByteTileGrid::get_memory_usage() const
+{
+    return sizeof(*this) + tiles.get_capacity();
+}
+
+TileStorage ByteTileGrid::get_storage() const
+{
+    return TileStorage::BYTES;
+}
+
+
+/* Constructor for the `PackedTileGrid` class
+ * Packs the tiles of each row two to a byte
+ * Throws an `std::invalid_argument` if a value in `matrix` isn't a tile
+ */
+PackedTileGrid::PackedTileGrid(const ByteMatrix2D & matrix)
+{
+    using namespace std;
+
+    const PackingTables & TABLES = packing_tables();
+
+    width = matrix.get_width();
+    height = matrix.get_height();
+    row_bytes = ((size_t)width + 1) / 2;
+    packed.assign(row_bytes * height, 0);
+
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        const uint8_t * ROW = matrix.row(y);
+        uint8_t * out = packed.data() + row_bytes * y;
+
+        for (matrix_dim_t x = 0; x < width; ++x)
+        {
+            const uint8_t CODE = TABLES.encode[ROW[x]];
+            if (CODE == NOT_A_TILE)
+            {
+                throw invalid_argument("PackedTileGrid: value " + to_string(ROW[x]) + " at ("
+                    + to_string(x) + ", " + to_string(y) + ") isn't a tile");
+            }
+
+            out[x / 2] |= (x % 2 == 0) ? CODE : (CODE << 4);
+        }
+    }
+}
+
+uint8_t PackedTileGrid::get_tile(matrix_dim_t x, matrix_dim_t y) const
+{
+    check_bounds(x, y);
+
+    const uint8_t BYTE = packed[row_bytes * y + x / 2];
+    return packing_tables().decode[BYTE][x % 2];
+}
+
+/* Writes out row `y`
+ * Each packed byte is turned into both of its tiles with a single table lookup
+ */
+void PackedTileGrid::decode_row(matrix_dim_t y, uint8_t * out) const
+{
+    check_bounds(0, y);
+
+    const PackingTables & TABLES = packing_tables();
+    const uint8_t * ROW = packed.data() + row_bytes * y;
+
+    // every byte but the last one is two whole tiles
+    const size_t FULL_BYTES = width / 2;
+    for (size_t i = 0; i < FULL_BYTES; ++i)
+    {
+        memcpy(out + 2 * i, TABLES.decode[ROW[i]], 2);
+    }
+
+    // the last byte of a row with an odd width only has one tile in it
+    if (width % 2 != 0)
+        out[width - 1] = TABLES.decode[ROW[FULL_BYTES]][0];
+}
+
+size_t PackedTileGrid::get_memory_usage() const
+{
+    return sizeof(*this) + packed.capacity();
+}
+
+TileStorage PackedTileGrid::get_storage() const
+{
+    return TileStorage::PACKED_4BIT;
+}
+
+
+/* Constructor for the `RleTileGrid` class
+ * Splits each row into runs of the same tile (at most `MAX_RUN` long)
+ */
+RleTileGrid::RleTileGrid(const ByteMatrix2D & matrix)
+{
+    width = matrix.get_width();
+    height = matrix.get_height();
+
+    row_offsets.resize((size_t)height + 1);
+    // at least one run per row, plus a bit more for the rows with rooms in them
+    runs.reserve((size_t)height * 16);
+
+    for (matrix_dim_t y = 0; y < height; ++y)
+    {
+        row_offsets[y] = runs.size();
+
+        const uint8_t * ROW = matrix.row(y);
+        size_t x = 0;
+        while (x < width)
+        {
+            size_t run_end = x + 1;
+            while (run_end < width && run_end - x < MAX_RUN && ROW[run_end] == ROW[x])
+                run_end++;
+
+            runs.push_back(ROW[x]);
+            runs.push_back(run_end - x - 1);
+            x = run_end;
+        }
+    }
+    row_offsets[height] = runs.size();
+
+    // read-mostly, so there's no point in holding on to the extra space
+    runs.shrink_to_fit();
+}
+
+/* Returns the tile at (`x`, `y`)
+ * Walks the runs of row `y` until it gets to column `x`
+ */
+uint8_t RleTileGrid::get_tile(matrix_dim_t x, matrix_dim_t y) const
+{
+    check_bounds(x, y);
+
+    size_t row_x = 0;
+    uint32_t r = row_offsets[y];
+    while (true)
+    {
+        row_x += (size_t)runs[r + 1] + 1;
+        if (x < row_x)
+            return runs[r];
+        r += 2;
+    }
+}
+
+void RleTileGrid::decode_row(matrix_dim_t y, uint8_t * out) const
+{
+    check_bounds(0, y);
+
+    for (uint32_t r = row_offsets[y]; r < row_offsets[y + 1]; r += 2)
+    {
+        const size_t LENGTH = (size_t)runs[r + 1] + 1;
+        memset(out, runs[r], LENGTH);
+        out += LENGTH;
+    }
+}
+
+size_t RleTileGrid::get_memory_usage() const
+{
+    return sizeof(*this) + row_offsets.capacity() * sizeof(uint32_t) + runs.capacity();
+}
+
+TileStorage RleTileGrid::get_storage() const
+{
+    return TileStorage::ROW_RLE;
+}
+
+
+/* Copies the tiles of `matrix` into a new grid of the given kind
+ */
+std::unique_ptr<TileGrid> make_tile_grid(const ByteMatrix2D & matrix, TileStorage storage)
+{
+    using namespace std;
+
+    switch (storage)
+    {
+        case TileStorage::PACKED_4BIT:
+            return make_unique<PackedTileGrid>(matrix);
+        case TileStorage::ROW_RLE:
+            return make_unique<RleTileGrid>(matrix);
+        case TileStorage::BYTES:
+        default:
+            return make_unique<ByteTileGrid>(matrix);
+    }
+}
+
+
+
+// Getters
+// (self explanatory)
+matrix_dim_t TileGrid::get_width() const
+{
+    return width;
+}
+matrix_dim_t TileGrid::get_height() const
+{
+    return height;
+}
+const std::vector<uint32_t> & RleTileGrid::get_row_offsets() const
+{
+    return row_offsets;
+}
+const std::vector<uint8_t> & RleTileGrid::get_runs() const
+{
+    return runs;
+}
@@ -0,0 +1,147 @@
+/* Rosa Knowles
+ * 11/21/2025
+ * Header file for `TileGrid`, a read-only grid of tiles that can be stored in a few different ways
+ * Generating a map needs one byte per tile (see `ByteMatrix2D`), but a finished map can be stored much more compactly:
+ *      - `ByteTileGrid` keeps one byte per tile, so every read is just a lookup
+ *      - `PackedTileGrid` packs two tiles into each byte, since there are only a handful of kinds of tiles
+ *      - `RleTileGrid` run length encodes each row, which is tiny for maps that are mostly empty space,
+ *        but has to walk a row to find a single tile
+ * Every kind can be read a whole row at a time with `decode_row`, which is what `as_str` and `write_to` use
+ */
+
+#ifndef TILEGRID_H
+#define TILEGRID_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <memory>
+#include <iosfwd>
+
+#include "dungeongen.h"
+
+
+/* The ways a `TileGrid` can be stored
+ */
+enum class TileStorage : uint8_t
+{
+    BYTES,          // `ByteTileGrid`
+    PACKED_4BIT,    // `PackedTileGrid`
+    ROW_RLE         // `RleTileGrid`
+};
+
+
+class TileGrid
+{
+    protected:
+        matrix_dim_t width = 0;
+        matrix_dim_t height = 0;
+
+        // throws an `std::out_of_range` if (`x`, `y`) is outside of the grid
+        void check_bounds(matrix_dim_t x, matrix_dim_t y) const;
+
+    public:
+        virtual ~TileGrid() = default;
+
+        // returns the tile at (`x`, `y`)
+        // throws an `std::out_of_range` if the coordinates are outside of the grid
+        virtual uint8_t get_tile(matrix_dim_t x, matrix_dim_t y) const = 0;
+        // writes the `width` tiles of row `y` to `out`
+        // throws an `std::out_of_range` if `y` is outside of the grid
+        virtual void decode_row(matrix_dim_t y, uint8_t * out) const = 0;
+        // bytes held by the grid
+        virtual size_t get_memory_usage() const = 0;
+        virtual TileStorage get_storage() const = 0;
+
+        // converts the grid to a string using the tiles, with a newline between each row (same as `DungeonMap::as_str`)
+        std::string as_str() const;
+        // writes the same text as `as_str` to a stream, without building the string
+        void write_to(std::ostream & os) const;
+        // decodes the whole grid back into a matrix, one byte per tile
+        ByteMatrix2D to_matrix() const;
+
+        // getters
+        matrix_dim_t get_width() const;
+        matrix_dim_t get_height() const;
+};
+
+
+/* One byte per tile, stored in a `ByteMatrix2D`
+ */
+class ByteTileGrid : public TileGrid
+{
+    private:
+        ByteMatrix2D tiles;
+
+    public:
+        // constructor
+        explicit ByteTileGrid(const ByteMatrix2D & matrix);
+
+        uint8_t get_tile(matrix_dim_t x, matrix_dim_t y) const override;
+        void decode_row(matrix_dim_t y, uint8_t * out) const override;
+        size_t get_memory_usage() const override;
+        TileStorage get_storage() const override;
+};
+
+
+/* Two tiles per byte
+ * Each tile is stored as a 4-bit code (its index in `PackedTileGrid::CODES`), the even column in the low half of the byte
+ * Every row starts on a new byte, so a row is `(width + 1) / 2` bytes
+ */
+class PackedTileGrid : public TileGrid
+{
+    private:
+        std::vector<uint8_t> packed;
+        size_t row_bytes = 0;
+
+    public:
+        // the tile each 4-bit code stands for
+        static const uint8_t CODES[5];
+
+        // constructor
+        // throws an `std::invalid_argument` if `matrix` has a value that isn't one of the tiles in `TILES`
+        explicit PackedTileGrid(const ByteMatrix2D & matrix);
+
+        uint8_t get_tile(matrix_dim_t x, matrix_dim_t y) const override;
+        void decode_row(matrix_dim_t y, uint8_t * out) const override;
+        size_t get_memory_usage() const override;
+        TileStorage get_storage() const override;
+};
+
+
+/* Each row is stored as runs of the same tile
+ * A run is two bytes: the tile, then the length of the run minus 1, and runs never cross a row
+ * This is the same layout as the compressed tiles section of a map file (see `mapfile.h`)
+ */
+class RleTileGrid : public TileGrid
+{
+    private:
+        // row `y` is the runs in [`row_offsets[y]`, `row_offsets[y + 1]`) of `runs`
+        std::vector<uint32_t> row_offsets;
+        std::vector<uint8_t> runs;
+
+    public:
+        // longest run that fits in a single run
+        static const size_t MAX_RUN = 256;
+
+        // constructor
+        explicit RleTileGrid(const ByteMatrix2D & matrix);
+
+        // has to walk the runs of the row, so use `decode_row` to read a lot of tiles
+        uint8_t get_tile(matrix_dim_t x, matrix_dim_t y) const override;
+        void decode_row(matrix_dim_t y, uint8_t * out) const override;
+        size_t get_memory_usage() const override;
+        TileStorage get_storage() const override;
+
+        // getters
+        // `height + 1` offsets into `runs`, one for the start of each row, and one for the end of the last row
+        const std::vector<uint32_t> & get_row_offsets() const;
+        const std::vector<uint8_t> & get_runs() const;
+};
+
+
+// copies the tiles of `matrix` into a new grid of the given kind
+std::unique_ptr<TileGrid> make_tile_grid(const ByteMatrix2D & matrix, TileStorage storage);
+
+#endif
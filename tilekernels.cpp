@@ -0,0 +1,263 @@
+/* Rosa Knowles
+ * 11/12/2025
+ * Definitions for the functions in the `tk` namespace
+ */
+
+#include "tilekernels.h"
+#include "threadpool.h"
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <bitset>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    /* Writes 0xFF to `mask[x]` if `row[x]` is a floor tile, and 0 otherwise
+     */
+    void floor_mask(const uint8_t * row, uint8_t * mask, size_t width)
+    {
+        size_t x = 0;
+
+        #if defined(__AVX2__)
+            const __m256i FLOOR_32 = _mm256_set1_epi8((char)TILES::FLOOR);
+            for (; x + 32 <= width; x += 32)
+            {
+                const __m256i TILES_32 = _mm256_loadu_si256((const __m256i *)(row + x));
+                _mm256_storeu_si256((__m256i *)(mask + x), _mm256_cmpeq_epi8(TILES_32, FLOOR_32));
+            }
+        #endif
+        #if defined(__SSE2__)
+            const __m128i FLOOR_16 = _mm_set1_epi8((char)TILES::FLOOR);
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i TILES_16 = _mm_loadu_si128((const __m128i *)(row + x));
+                _mm_storeu_si128((__m128i *)(mask + x), _mm_cmpeq_epi8(TILES_16, FLOOR_16));
+            }
+        #endif
+
+        for (; x < width; ++x)
+        {
+            mask[x] = (row[x] == TILES::FLOOR) ? 0xFF : 0;
+        }
+    }
+
+    /* Spreads a floor mask one tile to the left and right
+     * `padded` has one byte of padding (always 0) on each side of the row,
+     * so `out[x]` is just the OR of `padded[x]`, `padded[x + 1]` and `padded[x + 2]`
+     */
+    void dilate_horizontal(const uint8_t * padded, uint8_t * out, size_t width)
+    {
+        size_t x = 0;
+
+        #if defined(__AVX2__)
+            for (; x + 32 <= width; x += 32)
+            {
+                const __m256i LEFT   = _mm256_loadu_si256((const __m256i *)(padded + x));
+                const __m256i MIDDLE = _mm256_loadu_si256((const __m256i *)(padded + x + 1));
+                const __m256i RIGHT  = _mm256_loadu_si256((const __m256i *)(padded + x + 2));
+                _mm256_storeu_si256((__m256i *)(out + x), _mm256_or_si256(_mm256_or_si256(LEFT, MIDDLE), RIGHT));
+            }
+        #endif
+        #if defined(__SSE2__)
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i LEFT   = _mm_loadu_si128((const __m128i *)(padded + x));
+                const __m128i MIDDLE = _mm_loadu_si128((const __m128i *)(padded + x + 1));
+                const __m128i RIGHT  = _mm_loadu_si128((const __m128i *)(padded + x + 2));
+                _mm_storeu_si128((__m128i *)(out + x), _mm_or_si128(_mm_or_si128(LEFT, MIDDLE), RIGHT));
+            }
+        #endif
+
+        for (; x < width; ++x)
+        {
+            out[x] = padded[x] | padded[x + 1] | padded[x + 2];
+        }
+    }
+
+    /* Turns the empty tiles in `row` into walls wherever the rows above, at, or below it have a floor nearby
+     * `above`, `middle` and `below` are the horizontally spread floor masks of those rows
+     * Returns the number of walls placed, counted from the same masks that pick the tiles
+     */
+    size_t place_walls(uint8_t * row, const uint8_t * above, const uint8_t * middle, const uint8_t * below, size_t width)
+    {
+        size_t x = 0;
+        size_t rtrnval = 0;
+
+        #if defined(__AVX2__)
+            const __m256i EMPTY_32 = _mm256_set1_epi8((char)TILES::EMPTY);
+            const __m256i WALL_32  = _mm256_set1_epi8((char)TILES::WALL);
+            for (; x + 32 <= width; x += 32)
+            {
+                const __m256i TILES_32 = _mm256_loadu_si256((const __m256i *)(row + x));
+                const __m256i NEAR_FLOOR = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(above + x)), _mm256_loadu_si256((const __m256i *)(middle + x))),
+                    _mm256_loadu_si256((const __m256i *)(below + x)));
+                const __m256i BECOMES_WALL = _mm256_and_si256(_mm256_cmpeq_epi8(TILES_32, EMPTY_32), NEAR_FLOOR);
+                rtrnval += std::bitset<32>((uint32_t)_mm256_movemask_epi8(BECOMES_WALL)).count();
+                _mm256_storeu_si256((__m256i *)(row + x), _mm256_blendv_epi8(TILES_32, WALL_32, BECOMES_WALL));
+            }
+        #endif
+        #if defined(__SSE2__)
+            const __m128i EMPTY_16 = _mm_set1_epi8((char)TILES::EMPTY);
+            const __m128i WALL_16  = _mm_set1_epi8((char)TILES::WALL);
+            for (; x + 16 <= width; x += 16)
+            {
+                const __m128i TILES_16 = _mm_loadu_si128((const __m128i *)(row + x));
+                const __m128i NEAR_FLOOR = _mm_or_si128(
+                    _mm_or_si128(_mm_loadu_si128((const __m128i *)(above + x)), _mm_loadu_si128((const __m128i *)(middle + x))),
+                    _mm_loadu_si128((const __m128i *)(below + x)));
+                const __m128i BECOMES_WALL = _mm_and_si128(_mm_cmpeq_epi8(TILES_16, EMPTY_16), NEAR_FLOOR);
+                rtrnval += std::bitset<16>((uint32_t)_mm_movemask_epi8(BECOMES_WALL)).count();
+                // SSE2 doesn't have a byte blend, so build it out of and/andnot/or
+                _mm_storeu_si128((__m128i *)(row + x),
+                    _mm_or_si128(_mm_and_si128(BECOMES_WALL, WALL_16), _mm_andnot_si128(BECOMES_WALL, TILES_16)));
+            }
+        #endif
+
+        for (; x < width; ++x)
+        {
+            if (row[x] == TILES::EMPTY && (above[x] | middle[x] | below[x]))
+            {
+                row[x] = TILES::WALL;
+                rtrnval++;
+            }
+        }
+
+        return rtrnval;
+    }
+
+    // bytes of scratch space `dilate_band` needs, one padded row of floor mask and three rows of spread floor masks
+    size_t band_scratch_bytes(size_t width)
+    {
+        return (width + 2) + 3 * width;
+    }
+
+    /* Fills `out` with the spread floor mask of `row`
+     * `padded` is `width + 2` bytes of scratch space, whose first and last bytes have to be 0
+     */
+    void spread_floor_mask(const uint8_t * row, uint8_t * padded, uint8_t * out, size_t width)
+    {
+        floor_mask(row, padded + 1, width);
+        dilate_horizontal(padded, out, width);
+    }
+
+    /* Places the walls in rows [`y_begin`, `y_end`) of `tiles`
+     * `outside_above` and `outside_below` are the spread floor masks of rows `y_begin - 1` and `y_end`,
+     * or `nullptr` if those rows are outside of the grid
+     * `scratch` is `band_scratch_bytes(width)` bytes, starting with the padded row that `spread_floor_mask` needs
+     * Returns the number of walls placed
+     */
+    size_t dilate_band(uint8_t * tiles, size_t width, size_t y_begin, size_t y_end,
+                     const uint8_t * outside_above, const uint8_t * outside_below, uint8_t * scratch)
+    {
+        uint8_t * padded = scratch;
+        uint8_t * above  = padded + width + 2;
+        uint8_t * middle = above + width;
+        uint8_t * below  = middle + width;
+
+        if (outside_above != nullptr)
+            memcpy(above, outside_above, width);
+        else
+            memset(above, 0, width);
+
+        spread_floor_mask(tiles + y_begin * width, padded, middle, width);
+
+        size_t rtrnval = 0;
+        for (size_t y = y_begin; y < y_end; ++y)
+        {
+            if (y + 1 < y_end)
+                spread_floor_mask(tiles + (y + 1) * width, padded, below, width);
+            else if (outside_below != nullptr)
+                memcpy(below, outside_below, width);
+            else
+                memset(below, 0, width);
+
+            rtrnval += place_walls(tiles + y * width, above, middle, below, width);
+
+            // shift the masks up by one row
+            // `below` gets overwritten at the start of the next iteration, so it can take the old `above`
+            uint8_t * old_above = above;
+            above = middle;
+            middle = below;
+            below = old_above;
+        }
+
+        return rtrnval;
+    }
+};
+
+
+/* Turns every empty tile next to a floor tile into a wall tile
+ * Goes through the grid one row at a time, keeping the spread floor masks of the rows above and below the current row
+ * The mask of the next row is always built before the current row gets written to,
+ * so new walls never affect which tiles count as being next to a floor
+ */
+size_t tk::dilate_walls(uint8_t * tiles, size_t width, size_t height, std::pmr::memory_resource * resource)
+{
+    using namespace std;
+
+    if (width == 0 || height == 0)
+        return 0;
+
+    pmr::vector<uint8_t> scratch(band_scratch_bytes(width), 0, resource);
+    return dilate_band(tiles, width, 0, height, nullptr, nullptr, scratch.data());
+}
+
+/* Same as the other `dilate_walls`, but splits the rows into bands and does each band on `pool`
+ * A band reads the floor masks of the rows just above and below it, which belong to the bands next to it,
+ * so those get built for every band before any band writes a wall
+ * All of the scratch space is allocated up front, since `resource` doesn't have to be safe to use from other threads
+ */
+size_t tk::dilate_walls(uint8_t * tiles, size_t width, size_t height, ThreadPool & pool, size_t num_bands,
+                        std::pmr::memory_resource * resource)
+{
+    using namespace std;
+
+    if (width == 0 || height == 0)
+        return 0;
+
+    num_bands = min(max<size_t>(num_bands, 1), height);
+    if (num_bands == 1)
+        return dilate_walls(tiles, width, height, resource);
+
+    // each band gets its own scratch rows, plus the spread masks of its first and last rows
+    const size_t SCRATCH_BYTES = band_scratch_bytes(width);
+    pmr::vector<uint8_t> scratch(num_bands * (SCRATCH_BYTES + 2 * width), 0, resource);
+    uint8_t * edges = scratch.data() + num_bands * SCRATCH_BYTES;
+
+    auto band_start = [&](size_t band) { return height * band / num_bands; };
+
+    // build the masks of the rows on the edges of every band, while nothing is writing to the tiles
+    pool.parallel_for(num_bands, [&](size_t band)
+    {
+        uint8_t * padded = scratch.data() + band * SCRATCH_BYTES;
+        spread_floor_mask(tiles + band_start(band) * width, padded, edges + 2 * band * width, width);
+        spread_floor_mask(tiles + (band_start(band + 1) - 1) * width, padded, edges + (2 * band + 1) * width, width);
+    });
+
+    // each band counts its own walls, so no two threads write to the same count
+    pmr::vector<size_t> band_walls(num_bands, 0, resource);
+    pool.parallel_for(num_bands, [&](size_t band)
+    {
+        // the last row of the band above, and the first row of the band below
+        const uint8_t * outside_above = (band > 0) ? edges + (2 * band - 1) * width : nullptr;
+        const uint8_t * outside_below = (band + 1 < num_bands) ? edges + (2 * band + 2) * width : nullptr;
+
+        band_walls[band] = dilate_band(tiles, width, band_start(band), band_start(band + 1), outside_above, outside_below,
+                                       scratch.data() + band * SCRATCH_BYTES);
+    });
+
+    size_t rtrnval = 0;
+    for (size_t walls : band_walls)
+    {
+        rtrnval += walls;
+    }
+    return rtrnval;
+}
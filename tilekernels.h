@@ -0,0 +1,35 @@
+/* Rosa Knowles
+ * 11/12/2025
+ * Header file for functions that work on a whole grid of tiles at once
+ * These work directly on the bytes of a `ByteMatrix2D` (row-major, `width` bytes per row),
+ * and use SSE2/AVX2 when the compiler has them available
+ */
+
+#ifndef TILEKERNELS_H
+#define TILEKERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory_resource>
+
+#include "dungeongen.h"
+
+// defined in `threadpool.h`
+class ThreadPool;
+
+
+namespace tk
+{
+    // turns every `TILES::EMPTY` tile that touches a `TILES::FLOOR` tile (including diagonally) into a `TILES::WALL` tile
+    // tiles outside of the grid count as empty, so this never reads or writes out of bounds
+    // the few rows of scratch space it needs come from `resource`
+    // returns the number of walls it placed
+    size_t dilate_walls(uint8_t * tiles, size_t width, size_t height,
+                      std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+    // same as above, but splits the grid into `num_bands` bands of rows and places the walls in each band on `pool`
+    // comes out exactly the same as the single threaded version
+    size_t dilate_walls(uint8_t * tiles, size_t width, size_t height, ThreadPool & pool, size_t num_bands,
+                      std::pmr::memory_resource * resource = std::pmr::get_default_resource());
+};
+
+#endif
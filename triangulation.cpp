@@ -0,0 +1,668 @@
+/* Rosa Knowles
+ * 11/05/2025
+ * Definitions for the functions and methods in the `dt` namespace
+ */
+
+#include "triangulation.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    #include <immintrin.h>
+#endif
+
+
+// blank namespace b/c these should only be used within this file
+namespace
+{
+    // machine epsilon for doubles, used to bound rounding error
+    const double MACHINE_EPSILON = std::numeric_limits<double>::epsilon();
+
+    // how much bigger the super triangle is than the bounding box of the points
+    // needs to be big enough that the super triangle's vertices don't end up inside the circumcircles
+    // of triangles along the convex hull, but small enough that `dt::in_circle` can't overflow
+    const int64_t SUPER_TRIANGLE_SCALE = 256;
+
+    // number of triangles a point location walk can cross before giving up and checking every triangle instead
+    // with the points in hilbert curve order, a walk almost never takes more than a few dozen steps
+    const uint32_t MAX_WALK_STEPS = 1024;
+
+    // position of the point (`x`, `y`) along a hilbert curve that fills a 2^16 x 2^16 square
+    // inserting points in this order keeps each point close to the one before it,
+    // which keeps the point location walks short
+    // https://en.wikipedia.org/wiki/Hilbert_curve
+    uint64_t hilbert_index(uint32_t x, uint32_t y)
+    {
+        const uint32_t SIDE = 1 << 16;
+
+        uint64_t rtrnval = 0;
+
+        for (uint32_t s = SIDE / 2; s > 0; s /= 2)
+        {
+            const uint32_t RX = (x & s) > 0;
+            const uint32_t RY = (y & s) > 0;
+
+            rtrnval += (uint64_t)s * s * ((3 * RX) ^ RY);
+
+            // rotate the quadrant so the curve stays continuous
+            if (RY == 0)
+            {
+                if (RX == 1)
+                {
+                    x = SIDE - 1 - x;
+                    y = SIDE - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+
+        return rtrnval;
+    }
+};
+
+
+/* Twice the signed area of the triangle `a`, `b`, `c`
+ * Coordinates are integers, so this is computed exactly using 64-bit integers
+ */
+int64_t dt::orient2d(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c)
+{
+    const int64_t ACX = (int64_t)a.X - c.X;
+    const int64_t ACY = (int64_t)a.Y - c.Y;
+    const int64_t BCX = (int64_t)b.X - c.X;
+    const int64_t BCY = (int64_t)b.Y - c.Y;
+
+    return ACX * BCY - ACY * BCX;
+}
+
+/* Checks whether `d` lies inside the circumcircle of the counterclockwise triangle `a`, `b`, `c`
+ * This is the sign of the determinant
+ *      | adx  ady  adx^2 + ady^2 |
+ *      | bdx  bdy  bdx^2 + bdy^2 |
+ *      | cdx  cdy  cdx^2 + cdy^2 |
+ * where adx = a.X - d.X, etc.
+ * The products need more than 64 bits, so the determinant is computed with 128-bit integers
+ */
+int dt::in_circle(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c, const CoordinatePair & d)
+{
+    const int64_t ADX = (int64_t)a.X - d.X;
+    const int64_t ADY = (int64_t)a.Y - d.Y;
+    const int64_t BDX = (int64_t)b.X - d.X;
+    const int64_t BDY = (int64_t)b.Y - d.Y;
+    const int64_t CDX = (int64_t)c.X - d.X;
+    const int64_t CDY = (int64_t)c.Y - d.Y;
+
+    const __int128 A_LIFT = (__int128)ADX * ADX + (__int128)ADY * ADY;
+    const __int128 B_LIFT = (__int128)BDX * BDX + (__int128)BDY * BDY;
+    const __int128 C_LIFT = (__int128)CDX * CDX + (__int128)CDY * CDY;
+
+    const __int128 DET =
+        A_LIFT * ((__int128)BDX * CDY - (__int128)BDY * CDX) +
+        B_LIFT * ((__int128)CDX * ADY - (__int128)CDY * ADX) +
+        C_LIFT * ((__int128)ADX * BDY - (__int128)ADY * BDX);
+
+    if (DET > 0)
+        return 1;
+    if (DET < 0)
+        return -1;
+    return 0;
+}
+
+/* Same as `dt::in_circle`, except for when `d` is exactly on the circle
+ * Ties are broken with simulation of simplicity: each point's lifted coordinate (x^2 + y^2) is raised by a different,
+ * infinitely small amount, with the (x, y)-smallest point raised the most. The points then can't be on the same circle,
+ * and the sign of the perturbed determinant is the sign of the first nonzero coefficient, in that order
+ * The coefficient of each point's lift is its cofactor in the 4x4 in-circle determinant: the orientation of `b`, `c`, `d`
+ * for `a`, of `c`, `a`, `d` for `b`, of `a`, `b`, `d` for `c`, and minus the orientation of `a`, `b`, `c` for `d`
+ * Since the order only depends on the coordinates, cocircular points always get triangulated the same way
+ */
+int dt::in_circle_perturbed(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c, const CoordinatePair & d)
+{
+    const int EXACT = in_circle(a, b, c, d);
+    if (EXACT != 0)
+        return EXACT;
+
+    // a point is never inside a circle it is on
+    if (d == a || d == b || d == c)
+        return 0;
+
+    struct Term
+    {
+        const CoordinatePair * point;
+        int64_t coefficient;
+    };
+    Term terms[4] =
+    {
+        {&a, orient2d(b, c, d)},
+        {&b, orient2d(c, a, d)},
+        {&c, orient2d(a, b, d)},
+        {&d, -orient2d(a, b, c)}
+    };
+
+    // sort the terms by their point, smallest first
+    auto point_less = [](const CoordinatePair * p, const CoordinatePair * q)
+    {
+        return p->X < q->X || (p->X == q->X && p->Y < q->Y);
+    };
+    for (int i = 1; i < 4; ++i)
+    {
+        for (int j = i; j > 0 && point_less(terms[j].point, terms[j - 1].point); --j)
+            std::swap(terms[j], terms[j - 1]);
+    }
+
+    // `a`, `b`, `c` is a real triangle, so at least the coefficient of `d` isn't 0
+    for (const auto & t : terms)
+    {
+        if (t.coefficient > 0)
+            return 1;
+        if (t.coefficient < 0)
+            return -1;
+    }
+    return 0;
+}
+
+
+/* Private function
+ * Creates a new triangle with the counterclockwise vertices `a`, `b`, `c`
+ * Reuses the slot of a dead triangle if there is one
+ * Calculates and caches the circumcircle of the triangle
+ * Returns the index of the new triangle
+ */
+uint32_t dt::Triangulation::new_face(uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t index;
+    if (free_faces.empty())
+    {
+        index = faces.size();
+        faces.emplace_back();
+        face_stamp.push_back(0);
+
+        anchor_x.push_back(0);
+        anchor_y.push_back(0);
+        cc_x.push_back(0);
+        cc_y.push_back(0);
+        cc_outer_sq.push_back(0);
+        cc_inner_sq.push_back(0);
+    }
+    else
+    {
+        index = free_faces.back();
+        free_faces.pop_back();
+    }
+
+    faces_created++;
+
+    Face & f = faces[index];
+    f.vertices[0] = a;
+    f.vertices[1] = b;
+    f.vertices[2] = c;
+    f.neighbors[0] = NO_NEIGHBOR;
+    f.neighbors[1] = NO_NEIGHBOR;
+    f.neighbors[2] = NO_NEIGHBOR;
+    f.alive = true;
+
+    // find circumcircle, relative to `a` so the numbers stay small
+    // https://en.wikipedia.org/wiki/Circumcircle#Cartesian_coordinates_2
+    const CoordinatePair & A = vertices[a];
+    const int64_t BX = (int64_t)vertices[b].X - A.X;
+    const int64_t BY = (int64_t)vertices[b].Y - A.Y;
+    const int64_t CX = (int64_t)vertices[c].X - A.X;
+    const int64_t CY = (int64_t)vertices[c].Y - A.Y;
+
+    const double DENOMINATOR = 2.0 * (double)(BX * CY - BY * CX);
+    const double B_SQ = (double)(BX * BX + BY * BY);
+    const double C_SQ = (double)(CX * CX + CY * CY);
+
+    const double CC_X = (CY * B_SQ - BY * C_SQ) / DENOMINATOR;
+    const double CC_Y = (BX * C_SQ - CX * B_SQ) / DENOMINATOR;
+    const double RADIUS = sqrt(CC_X * CC_X + CC_Y * CC_Y);
+
+    // bound on the rounding error of the circumcenter
+    // each numerator has two rounded products and a rounded difference, and then there's the division
+    const double ERROR_X = 4 * MACHINE_EPSILON * (fabs(CY * B_SQ) + fabs(BY * C_SQ)) / fabs(DENOMINATOR);
+    const double ERROR_Y = 4 * MACHINE_EPSILON * (fabs(BX * C_SQ) + fabs(CX * B_SQ)) / fabs(DENOMINATOR);
+    const double CC_ERROR = ERROR_X + ERROR_Y + 2 * MACHINE_EPSILON * (fabs(CC_X) + fabs(CC_Y));
+
+    // the real circumcenter is within `CC_ERROR` of the cached one,
+    // so the distance to a point and the radius are each off by at most `CC_ERROR`
+    // squaring the bounds here means checking a point never needs a `sqrt`
+    const double SLACK = 2 * CC_ERROR;
+    const double OUTER = RADIUS + SLACK;
+    const double INNER = RADIUS - SLACK;
+
+    anchor_x[index] = A.X;
+    anchor_y[index] = A.Y;
+    cc_x[index] = CC_X;
+    cc_y[index] = CC_Y;
+    cc_outer_sq[index] = OUTER * OUTER * (1 + 1e-12);
+    cc_inner_sq[index] = (INNER > 0) ? INNER * INNER * (1 - 1e-12) : -1;
+
+    return index;
+}
+
+/* Private function
+ * Marks a triangle as dead, so its slot can be reused
+ */
+void dt::Triangulation::kill_face(uint32_t f)
+{
+    faces[f].alive = false;
+    free_faces.push_back(f);
+
+    // nothing is ever inside a dead triangle's circumcircle
+    cc_outer_sq[f] = -1;
+    cc_inner_sq[f] = -1;
+    faces_destroyed++;
+}
+
+/* Private function
+ * Checks whether `p` is inside the circumcircle of the triangle `f` (see `dt::in_circle_perturbed` for points on it)
+ * Uses the cached circumcircle when `p` is clearly inside or clearly outside of it,
+ * and falls back to the exact `dt::in_circle` when it is too close to call
+ */
+bool dt::Triangulation::face_contains_in_circle(uint32_t f, const CoordinatePair & p) const
+{
+    const double DX = ((double)p.X - anchor_x[f]) - cc_x[f];
+    const double DY = ((double)p.Y - anchor_y[f]) - cc_y[f];
+    const double DIST_SQ = DX * DX + DY * DY;
+
+    if (DIST_SQ > cc_outer_sq[f])
+        return false;
+
+    if (DIST_SQ < cc_inner_sq[f])
+        return true;
+
+    // dead triangles always get caught by `cc_outer_sq`, so this is a live one
+    const Face & face = faces[f];
+    // ties are broken the same way every time, so points on the same circle don't depend on the order they were inserted in
+    return in_circle_perturbed(vertices[face.vertices[0]], vertices[face.vertices[1]], vertices[face.vertices[2]], p) > 0;
+}
+
+/* Private function
+ * Checks every triangle, and returns the first one whose circumcircle contains `p`
+ * The cached circumcircles rule out almost every triangle, a few at a time with SIMD,
+ * and only the ones that are too close to call get the exact check
+ * Returns `NO_NEIGHBOR` if `p` isn't inside any circumcircle, which only happens if it is already a vertex
+ */
+uint32_t dt::Triangulation::scan_conflicts(const CoordinatePair & p) const
+{
+    const size_t NUM_FACES = faces.size();
+    const double PX = p.X;
+    const double PY = p.Y;
+
+    size_t f = 0;
+    while (f < NUM_FACES)
+    {
+        // skip ahead to the next triangle that `p` isn't definitely outside of
+        #if defined(__AVX2__)
+            const __m256d PX_4 = _mm256_set1_pd(PX);
+            const __m256d PY_4 = _mm256_set1_pd(PY);
+            for (; f + 4 <= NUM_FACES; f += 4)
+            {
+                const __m256d DX = _mm256_sub_pd(_mm256_sub_pd(PX_4, _mm256_loadu_pd(&anchor_x[f])), _mm256_loadu_pd(&cc_x[f]));
+                const __m256d DY = _mm256_sub_pd(_mm256_sub_pd(PY_4, _mm256_loadu_pd(&anchor_y[f])), _mm256_loadu_pd(&cc_y[f]));
+                const __m256d DIST_SQ = _mm256_add_pd(_mm256_mul_pd(DX, DX), _mm256_mul_pd(DY, DY));
+
+                if (_mm256_movemask_pd(_mm256_cmp_pd(DIST_SQ, _mm256_loadu_pd(&cc_outer_sq[f]), _CMP_LE_OQ)) != 0)
+                    break;
+            }
+        #elif defined(__SSE2__)
+            const __m128d PX_2 = _mm_set1_pd(PX);
+            const __m128d PY_2 = _mm_set1_pd(PY);
+            for (; f + 2 <= NUM_FACES; f += 2)
+            {
+                const __m128d DX = _mm_sub_pd(_mm_sub_pd(PX_2, _mm_loadu_pd(&anchor_x[f])), _mm_loadu_pd(&cc_x[f]));
+                const __m128d DY = _mm_sub_pd(_mm_sub_pd(PY_2, _mm_loadu_pd(&anchor_y[f])), _mm_loadu_pd(&cc_y[f]));
+                const __m128d DIST_SQ = _mm_add_pd(_mm_mul_pd(DX, DX), _mm_mul_pd(DY, DY));
+
+                if (_mm_movemask_pd(_mm_cmple_pd(DIST_SQ, _mm_loadu_pd(&cc_outer_sq[f]))) != 0)
+                    break;
+            }
+        #endif
+
+        // the triangle(s) the SIMD loop stopped on, or the ones left over at the end, get checked one at a time
+        // the SIMD loop only stops on a block that has a possible hit, so this never goes more than one block
+        const size_t BLOCK_END = std::min(NUM_FACES, f + 4);
+        for (; f < BLOCK_END; ++f)
+        {
+            if (face_contains_in_circle(f, p))
+                return f;
+        }
+    }
+
+    return NO_NEIGHBOR;
+}
+
+/* Private function
+ * Finds a triangle that contains `p` (either inside it or on one of its edges)
+ * Starts at the last triangle that was created and walks towards `p`,
+ * crossing any edge that `p` is on the other side of
+ */
+uint32_t dt::Triangulation::locate(const CoordinatePair & p) const
+{
+    uint32_t current = last_face;
+    // rotates which edge gets checked first, so the walk can't get stuck going in circles
+    uint32_t step = 0;
+
+    while (step < MAX_WALK_STEPS)
+    {
+        const Face & face = faces[current];
+        bool moved = false;
+
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            const uint32_t E = (k + step) % 3;
+            const CoordinatePair & A = vertices[face.vertices[E]];
+            const CoordinatePair & B = vertices[face.vertices[(E + 1) % 3]];
+
+            // `p` is on the other side of this edge
+            if (orient2d(A, B, p) < 0 && face.neighbors[E] != NO_NEIGHBOR)
+            {
+                current = face.neighbors[E];
+                moved = true;
+                break;
+            }
+        }
+
+        if (!moved)
+            return current;
+
+        step++;
+    }
+
+    return NO_NEIGHBOR;
+}
+
+/* Private function
+ * Inserts a single vertex into the triangulation
+ * Every triangle whose circumcircle contains the vertex gets removed, which leaves a hole (the cavity),
+ * and then the hole is filled with triangles that connect its edges to the new vertex
+ */
+void dt::Triangulation::insert(uint32_t vertex)
+{
+    const CoordinatePair & P = vertices[vertex];
+
+    uint32_t START = locate(P);
+
+    if (START == NO_NEIGHBOR)
+    {
+        // any triangle whose circumcircle contains the point is in the cavity, so it works just as well as a starting point
+        // if there isn't one, the point is already in the triangulation
+        scan_fallbacks++;
+        START = scan_conflicts(P);
+        if (START == NO_NEIGHBOR)
+            return;
+    }
+
+    // the point is already in the triangulation
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        if (vertices[faces[START].vertices[i]] == P)
+            return;
+    }
+
+    // `face_stamp[f] == stamp` means `f` is in the cavity
+    // `face_stamp[f] == stamp + 1` means `f` has been checked, and isn't in the cavity
+    stamp += 2;
+
+    cavity.clear();
+    boundary.clear();
+    new_faces.clear();
+
+    // the starting triangle contains the point, so it is always part of the cavity
+    cavity.push_back(START);
+    face_stamp[START] = stamp;
+
+    // grow the cavity outwards through the neighbors of each triangle in it
+    // NOTE: `cavity` grows while this loop runs, so it can't be a range-based for loop
+    for (size_t i = 0; i < cavity.size(); ++i)
+    {
+        const uint32_t F = cavity[i];
+
+        for (uint8_t e = 0; e < 3; ++e)
+        {
+            const uint32_t NEIGHBOR = faces[F].neighbors[e];
+
+            if (NEIGHBOR != NO_NEIGHBOR)
+            {
+                if (face_stamp[NEIGHBOR] == stamp)
+                    continue;
+
+                if (face_stamp[NEIGHBOR] != stamp + 1)
+                {
+                    if (face_contains_in_circle(NEIGHBOR, P))
+                    {
+                        face_stamp[NEIGHBOR] = stamp;
+                        cavity.push_back(NEIGHBOR);
+                        continue;
+                    }
+                    face_stamp[NEIGHBOR] = stamp + 1;
+                }
+            }
+
+            // this edge is on the outside of the cavity
+            BoundaryEdge be;
+            be.a = faces[F].vertices[e];
+            be.b = faces[F].vertices[(e + 1) % 3];
+            be.outer_face = NEIGHBOR;
+            be.outer_edge = 0;
+
+            if (NEIGHBOR != NO_NEIGHBOR)
+            {
+                while (faces[NEIGHBOR].neighbors[be.outer_edge] != F)
+                    be.outer_edge++;
+            }
+
+            boundary.push_back(be);
+        }
+    }
+
+    for (auto f : cavity)
+    {
+        kill_face(f);
+    }
+
+    // connect each edge of the cavity to the new vertex
+    for (const auto & be : boundary)
+    {
+        const uint32_t G = new_face(be.a, be.b, vertex);
+
+        faces[G].neighbors[0] = be.outer_face;
+        if (be.outer_face != NO_NEIGHBOR)
+            faces[be.outer_face].neighbors[be.outer_edge] = G;
+
+        // the edges of the cavity form a loop, so each vertex starts exactly one edge
+        vertex_face[be.a] = G;
+        new_faces.push_back(G);
+    }
+
+    // link the new triangles to each other
+    // the triangle across `b` -> `vertex` is the one whose cavity edge starts at `b`
+    for (auto g : new_faces)
+    {
+        const uint32_t H = vertex_face[faces[g].vertices[1]];
+        faces[g].neighbors[1] = H;
+        faces[H].neighbors[2] = g;
+    }
+
+    last_face = new_faces.back();
+}
+
+
+/* Constructor for the `Triangulation` class
+ * Points every container at `resource_arg`
+ */
+dt::Triangulation::Triangulation(std::pmr::memory_resource * resource_arg)
+    : resource(resource_arg), vertices(resource_arg), faces(resource_arg), free_faces(resource_arg),
+      anchor_x(resource_arg), anchor_y(resource_arg), cc_x(resource_arg), cc_y(resource_arg),
+      cc_outer_sq(resource_arg), cc_inner_sq(resource_arg),
+      cavity(resource_arg), boundary(resource_arg), new_faces(resource_arg), face_stamp(resource_arg),
+      vertex_face(resource_arg)
+{
+}
+
+/* Triangulates `points`
+ * Builds a super triangle around all of the points, then inserts the points one at a time
+ * Points are inserted in hilbert curve order, so each point location walk only takes a few steps
+ */
+void dt::Triangulation::triangulate(const CoordinatePair * points, size_t count)
+{
+    using namespace std;
+
+    vertices.assign(points, points + count);
+    num_points = count;
+    faces.clear();
+    free_faces.clear();
+    face_stamp.clear();
+    anchor_x.clear();
+    anchor_y.clear();
+    cc_x.clear();
+    cc_y.clear();
+    cc_outer_sq.clear();
+    cc_inner_sq.clear();
+    stamp = 0;
+    faces_created = 0;
+    faces_destroyed = 0;
+    scan_fallbacks = 0;
+
+    if (num_points == 0)
+        return;
+
+    // find the bounding box of the points
+    int64_t min_x = points[0].X, max_x = points[0].X;
+    int64_t min_y = points[0].Y, max_y = points[0].Y;
+    for (size_t i = 0; i < num_points; ++i)
+    {
+        const CoordinatePair & p = points[i];
+        min_x = min<int64_t>(min_x, p.X);
+        max_x = max<int64_t>(max_x, p.X);
+        min_y = min<int64_t>(min_y, p.Y);
+        max_y = max<int64_t>(max_y, p.Y);
+    }
+
+    // DETERMINE SUPER TRIANGLE
+    // a counterclockwise triangle that is way bigger than the bounding box
+    const int64_t SIDE = max<int64_t>(max(max_x - min_x, max_y - min_y), 1);
+    const int64_t MID_X = (min_x + max_x) / 2;
+    const int64_t MID_Y = (min_y + max_y) / 2;
+    const int64_t REACH = SUPER_TRIANGLE_SCALE * SIDE;
+
+    vertices.push_back({(int32_t)(MID_X - REACH), (int32_t)(MID_Y - REACH)});
+    vertices.push_back({(int32_t)(MID_X + REACH), (int32_t)(MID_Y - REACH)});
+    vertices.push_back({(int32_t)MID_X, (int32_t)(MID_Y + REACH)});
+
+    vertex_face.assign(vertices.size(), NO_NEIGHBOR);
+
+    last_face = new_face(num_points, num_points + 1, num_points + 2);
+
+    // sort the points along a hilbert curve
+    pmr::vector<pair<uint64_t, uint32_t>> order(resource);
+    order.reserve(num_points);
+    const int64_t SPAN_X = max<int64_t>(max_x - min_x, 1);
+    const int64_t SPAN_Y = max<int64_t>(max_y - min_y, 1);
+    for (uint32_t i = 0; i < num_points; ++i)
+    {
+        const uint32_t HX = (uint32_t)((points[i].X - min_x) * 65535 / SPAN_X);
+        const uint32_t HY = (uint32_t)((points[i].Y - min_y) * 65535 / SPAN_Y);
+        order.push_back({hilbert_index(HX, HY), i});
+    }
+    sort(order.begin(), order.end());
+
+    for (const auto & [key, index] : order)
+    {
+        insert(index);
+    }
+}
+
+/* Returns every triangle that doesn't use a vertex of the super triangle
+ * Vertices of each triangle are counterclockwise
+ */
+std::pmr::vector<Triangle> dt::Triangulation::get_triangles() const
+{
+    std::pmr::vector<Triangle> rtrnval(resource);
+
+    for (const auto & f : faces)
+    {
+        if (!f.alive)
+            continue;
+
+        // super triangle vertices are stored after all of the real points
+        if (f.vertices[0] >= num_points || f.vertices[1] >= num_points || f.vertices[2] >= num_points)
+            continue;
+
+        Triangle tr;
+        tr.p1 = vertices[f.vertices[0]];
+        tr.p2 = vertices[f.vertices[1]];
+        tr.p3 = vertices[f.vertices[2]];
+        rtrnval.push_back(tr);
+    }
+
+    return rtrnval;
+}
+
+/* Returns every edge of the triangles from `get_triangles` once
+ * Each edge is shared by (at most) two triangles, so it is only added by the one with the lower index,
+ * or by the only one if the other triangle is dead, touches the super triangle, or doesn't exist
+ */
+std::pmr::vector<std::pair<uint32_t, uint32_t>> dt::Triangulation::get_edges() const
+{
+    std::pmr::vector<std::pair<uint32_t, uint32_t>> rtrnval(resource);
+
+    // super triangle vertices are stored after all of the real points
+    auto is_real = [&](uint32_t f)
+    {
+        return faces[f].alive
+            && faces[f].vertices[0] < num_points && faces[f].vertices[1] < num_points && faces[f].vertices[2] < num_points;
+    };
+
+    // a triangulation of n points has fewer than 3n edges
+    rtrnval.reserve(3 * num_points);
+
+    for (uint32_t f = 0; f < faces.size(); ++f)
+    {
+        if (!is_real(f))
+            continue;
+
+        for (uint8_t e = 0; e < 3; ++e)
+        {
+            const uint32_t NEIGHBOR = faces[f].neighbors[e];
+
+            if (NEIGHBOR == NO_NEIGHBOR || NEIGHBOR > f || !is_real(NEIGHBOR))
+                rtrnval.push_back({faces[f].vertices[e], faces[f].vertices[(e + 1) % 3]});
+        }
+    }
+
+    return rtrnval;
+}
+
+/* Returns the number of bytes reserved by the containers of the triangulation
+ * Uses the capacities, since that's what is actually allocated
+ */
+size_t dt::Triangulation::get_memory_usage() const
+{
+    return vertices.capacity() * sizeof(CoordinatePair)
+         + faces.capacity() * sizeof(Face)
+         + free_faces.capacity() * sizeof(uint32_t)
+         + (anchor_x.capacity() + anchor_y.capacity() + cc_x.capacity() + cc_y.capacity()
+            + cc_outer_sq.capacity() + cc_inner_sq.capacity()) * sizeof(double)
+         + cavity.capacity() * sizeof(uint32_t)
+         + boundary.capacity() * sizeof(BoundaryEdge)
+         + new_faces.capacity() * sizeof(uint32_t)
+         + face_stamp.capacity() * sizeof(uint32_t)
+         + vertex_face.capacity() * sizeof(uint32_t);
+}
+
+// Getters
+// (self explanatory)
+size_t dt::Triangulation::get_num_points() const
+{
+    return num_points;
+}
+uint64_t dt::Triangulation::get_faces_created() const
+{
+    return faces_created;
+}
+uint64_t dt::Triangulation::get_faces_destroyed() const
+{
+    return faces_destroyed;
+}
+uint64_t dt::Triangulation::get_scan_fallbacks() const
+{
+    return scan_fallbacks;
+}
@@ -0,0 +1,152 @@
+/* Rosa Knowles
+ * 11/05/2025
+ * Header file for `dt::Triangulation`, an incremental Delaunay triangulation
+ * Triangles are stored in a mesh where each triangle knows its three neighbors,
+ * so inserting a point only touches the triangles around it instead of the whole list
+ * The circumcircle of each triangle is cached in its own set of columns (structure of arrays),
+ * so checking a point against every triangle at once can use SIMD
+ * https://paulbourke.net/papers/triangulate/
+ * https://www.cs.cmu.edu/~quake/robust.html
+ */
+
+#ifndef TRIANGULATION_H
+#define TRIANGULATION_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <memory_resource>
+
+#include "dungeongen.h"
+
+
+// NOTE: "dt" stands for delaunay triangulation
+
+
+namespace dt
+{
+    // used for a triangle edge that sits on the outside of the mesh
+    const uint32_t NO_NEIGHBOR = UINT32_MAX;
+
+    // twice the signed area of the triangle `a`, `b`, `c`
+    // positive if the points are counterclockwise, negative if clockwise, 0 if collinear
+    // exact as long as the coordinates differ by less than 2^31
+    int64_t orient2d(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c);
+
+    // returns 1 if `d` is inside the circumcircle of the counterclockwise triangle `a`, `b`, `c`,
+    // -1 if it is outside, and 0 if it is on the circle
+    // exact as long as the coordinates differ by less than 2^30
+    int in_circle(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c, const CoordinatePair & d);
+    // same as `in_circle`, but breaks ties with symbolic perturbation, so it only returns 0 if `d` is one of `a`, `b`, `c`
+    // four or more points on the same circle always get triangulated the same way, no matter what order they come in
+    int in_circle_perturbed(const CoordinatePair & a, const CoordinatePair & b, const CoordinatePair & c, const CoordinatePair & d);
+
+
+    class Triangulation
+    {
+        private:
+            // a single triangle in the mesh
+            // vertices are stored counterclockwise
+            // `neighbors[i]` is the triangle on the other side of the edge `vertices[i]` -> `vertices[(i + 1) % 3]`
+            struct Face
+            {
+                uint32_t vertices[3];
+                uint32_t neighbors[3];
+
+                bool alive;
+            };
+
+            // an edge on the outside of the cavity made by an insertion
+            struct BoundaryEdge
+            {
+                uint32_t a;
+                uint32_t b;
+                uint32_t outer_face;
+                uint8_t  outer_edge;
+            };
+
+            // every container below gets its memory from here
+            std::pmr::memory_resource * resource;
+
+            // every point in the triangulation
+            // the last three are the vertices of the super triangle
+            std::pmr::vector<CoordinatePair> vertices;
+            size_t num_points = 0;
+
+            std::pmr::vector<Face>     faces;
+            std::pmr::vector<uint32_t> free_faces;
+
+            // cached circumcircle of each triangle, one column per value (index `f` is triangle `f`)
+            // `anchor_x`, `anchor_y` are the coordinates of the triangle's first vertex,
+            // and `cc_x`, `cc_y` are the circumcenter relative to it, so the numbers stay small
+            // a point whose squared distance to the circumcenter is more than `cc_outer_sq` is definitely outside,
+            // and less than `cc_inner_sq` is definitely inside (both include the rounding error)
+            // dead triangles have both set to -1, so they are always outside
+            std::pmr::vector<double> anchor_x;
+            std::pmr::vector<double> anchor_y;
+            std::pmr::vector<double> cc_x;
+            std::pmr::vector<double> cc_y;
+            std::pmr::vector<double> cc_outer_sq;
+            std::pmr::vector<double> cc_inner_sq;
+
+            // scratch space for insertions, kept around so it doesn't need to be reallocated
+            std::pmr::vector<uint32_t>     cavity;
+            std::pmr::vector<BoundaryEdge> boundary;
+            std::pmr::vector<uint32_t>     new_faces;
+            std::pmr::vector<uint32_t>     face_stamp;
+            std::pmr::vector<uint32_t>     vertex_face;
+            uint32_t stamp = 0;
+
+            // the most recently created triangle, where the next point location walk starts
+            uint32_t last_face = 0;
+
+            // number of triangles made and thrown away by the last call to `triangulate`
+            // (including the super triangle and everything touching it)
+            uint64_t faces_created = 0;
+            uint64_t faces_destroyed = 0;
+            // number of point location walks that took too long and fell back to `scan_conflicts`
+            uint64_t scan_fallbacks = 0;
+
+            uint32_t new_face(uint32_t a, uint32_t b, uint32_t c);
+            void kill_face(uint32_t f);
+            bool face_contains_in_circle(uint32_t f, const CoordinatePair & p) const;
+            // walks to the triangle that contains `p`, returns `NO_NEIGHBOR` if it takes too many steps
+            uint32_t locate(const CoordinatePair & p) const;
+            // checks every triangle, and returns one whose circumcircle contains `p` (`NO_NEIGHBOR` if there isn't one)
+            uint32_t scan_conflicts(const CoordinatePair & p) const;
+            void insert(uint32_t vertex);
+
+        public:
+            // constructor
+            // everything the triangulation allocates (including the list from `get_triangles`) comes from `resource_arg`
+            explicit Triangulation(std::pmr::memory_resource * resource_arg = std::pmr::get_default_resource());
+
+            // triangulates the `count` points starting at `points`
+            // any triangulation that was already stored is thrown away
+            void triangulate(const CoordinatePair * points, size_t count);
+            // same as above, for any container that stores its points contiguously (`std::vector`, `std::pmr::vector`, ...)
+            template <typename Container>
+            void triangulate(const Container & points)
+            {
+                triangulate(points.data(), points.size());
+            }
+
+            // returns every triangle that doesn't use a vertex of the super triangle
+            // the vertices of each triangle are counterclockwise
+            std::pmr::vector<Triangle> get_triangles() const;
+            // returns every edge of the triangles from `get_triangles`, each one only once
+            // the edges are pairs of indices into the points that were triangulated
+            std::pmr::vector<std::pair<uint32_t, uint32_t>> get_edges() const;
+
+            // bytes reserved by every container in the triangulation
+            size_t get_memory_usage() const;
+
+            // getters
+            size_t get_num_points() const;
+            uint64_t get_faces_created() const;
+            uint64_t get_faces_destroyed() const;
+            uint64_t get_scan_fallbacks() const;
+    };
+};
+
+#endif